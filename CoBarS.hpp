@@ -21,6 +21,35 @@
     #include <iostream>
     #include <random>
     #include <cstring>
+    #include <atomic>
+    #include <memory>
+    #include <array>
+    #include <unordered_map>
+    #include <thread>
+    #include <mutex>
+    #include <condition_variable>
+    #include <utility>
+    #include <optional>
+    #include <fstream>
+    #include <iterator>
+    #include <cstdio>
+    #include <stdexcept>
+
+    #include <cerrno>
+
+    // CoBarS::PolygonFile, Sampler::CreateRandomClosedPolygonsFile, and Sampler::ShardedConfidenceSample need POSIX (mmap, fork, pipes); they are left out on other systems. Checkpoints are then written without fsync.
+    #if __has_include(<unistd.h>) && __has_include(<sys/mman.h>) && __has_include(<sys/wait.h>)
+
+        #define COBARS_POSIX
+
+        #include <fcntl.h>
+        #include <sys/mman.h>
+        #include <sys/stat.h>
+        #include <unistd.h>
+        #include <sys/wait.h>
+        #include <signal.h>
+
+    #endif
 
     #include "submodules/Tensors/Tensors.hpp"
 
@@ -69,18 +98,92 @@
             return factor * std::exp( - Scalar::Half<Real> * z * z );
         }
         
+/*!
+ * Quantile function of Student's t-distribution, i.e., the `t` with `P(T <= t) = p`, for `p` in [1/2,1).
+ *
+ * With `t = sqrt(dof) tan(theta)`, the density of the t-distribution becomes proportional to `cos(theta)^(dof-1)` on (-pi/2,pi/2). We integrate this smooth function by Simpson's rule and invert the integral by bisection in `theta`.
+ *
+ * @tparam Real A real floating point type.
+ *
+ * @param p The probability.
+ *
+ * @param dof The degrees of freedom; must be at least 1.
+ */
+        template<typename Real>
+        Real StudentT_Quantile( const Real p, const Real dof )
+        {
+            static_assert(FloatQ<Real>, "");
+            
+            constexpr int  n       = 256;
+            constexpr Real half_pi = Scalar::Pi<Real> / Real(2);
+            
+            auto integral = [dof]( const Real theta )
+            {
+                const Real h = theta / Real(n);
+                
+                auto f = [dof]( const Real x )
+                {
+                    return std::pow( std::max( std::cos(x), Real(0) ), dof - Real(1) );
+                };
+                
+                Real sum = f(0) + f(theta);
+                
+                for( int k = 1; k < n; ++k )
+                {
+                    sum += Real( (k % 2 == 1) ? 4 : 2 ) * f( h * k );
+                }
+                
+                return sum * h / Real(3);
+            };
+            
+            const Real target = ( Real(2) * p - Real(1) ) * integral( half_pi );
+            
+            Real a = 0;
+            Real b = half_pi;
+            
+            for( int iter = 0; iter < 64; ++iter )
+            {
+                const Real c = Scalar::Half<Real> * (a + b);
+                
+                if( integral( c ) < target )
+                {
+                    a = c;
+                }
+                else
+                {
+                    b = c;
+                }
+            }
+            
+            return std::sqrt( dof ) * std::tan( Scalar::Half<Real> * (a + b) );
+        }
+        
     } // namespace CoBarS
     
     #include "src/MT64.hpp"
     #include "src/Xoshiro256Plus.hpp"
     #include "src/PCG64.hpp"
     #include "src/WyRand.hpp"
+    #include "src/Philox.hpp"
+    #include "src/RandomUnitVectors.hpp"
+    #include "src/ScrambledSobol.hpp"
 
     #include "src/GearyTransform.hpp"
+    #include "src/ConfidenceState.hpp"
+    #include "src/BoundedQueue.hpp"
+    #include "src/SampleBlock.hpp"
+#ifdef COBARS_POSIX
+    #include "src/PolygonFile.hpp"
+#endif
+    #include "src/CompactEncoding.hpp"
 
+    #include "src/SymmetricKernels.hpp"
+    #include "src/FixedVectorList.hpp"
     #include "src/SamplerSettings.hpp"
     #include "src/SamplerBase.hpp"
     #include "src/Sampler.hpp"
+    #include "src/BatchSampler.hpp"
+    #include "src/MakeSampler.hpp"
 
     #include "src/RandomVariable.hpp"
 
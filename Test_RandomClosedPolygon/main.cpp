@@ -23,15 +23,733 @@ using CoBarS::WyRand;
 // Xoshiro256+ by David Blackman and Sebastiano Vigna.
 using CoBarS::Xoshiro256Plus;
 
+// Philox4x32-10 by John K. Salmon, Mark A. Moraes, Ron O. Dror, and David E. Shaw. This one is counter-based; it produces several words at once, and the random numbers of each sample can be regenerated directly.
+using CoBarS::Philox4x32;
+
 // Typically, CoBarS::Xoshiro256Plus is the fastest number generator for doubles, because it creates only the 53 random bits required for a double---not more.
 // CoBarS::WyRand is almost as fast; it may have
 
-// See src/MT64.hpp, src/PCG64.hpp, src/WyRand.hpp, and src/Xoshiro256Plus.hpp for the implementation. This should also tell you how to roll out the pseudorandom number generator of your choice.
+// See src/MT64.hpp, src/PCG64.hpp, src/Philox.hpp, src/WyRand.hpp, and src/Xoshiro256Plus.hpp for the implementation. This should also tell you how to roll out the pseudorandom number generator of your choice.
+
+// Checks CoBarS::Philox4x32 against the known-answer vectors of Philox4x32-10 from Random123 (kat_vectors): counter and key all zeros, all 0xffffffff, and the hexadecimal digits of pi. The generator uses the counter (c_0,c_1,c_2,c_3) = (position, sample index) and the key (k_0,k_1) = seed, each split into 32-bit words, and returns (c_1,c_0) and (c_3,c_2) as 64-bit words.
+bool CheckPhiloxKnownAnswers()
+{
+    struct KnownAnswer
+    {
+        std::uint32_t counter [4];
+        std::uint32_t key     [2];
+        std::uint32_t result  [4];
+    };
+    
+    const KnownAnswer known_answers [] = {
+        {
+            { 0x00000000, 0x00000000, 0x00000000, 0x00000000 },
+            { 0x00000000, 0x00000000 },
+            { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 }
+        },
+        {
+            { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff },
+            { 0xffffffff, 0xffffffff },
+            { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd }
+        },
+        {
+            { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 },
+            { 0xa4093822, 0x299f31d0 },
+            { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 }
+        }
+    };
+    
+    auto join = []( const std::uint32_t lo, const std::uint32_t hi )
+    {
+        return (static_cast<std::uint64_t>(hi) << 32) | static_cast<std::uint64_t>(lo);
+    };
+    
+    bool passedQ = true;
+    
+    for( const KnownAnswer & v : known_answers )
+    {
+        Philox4x32 engine ( join(v.key[0], v.key[1]), join(v.counter[2], v.counter[3]) );
+        
+        // Each counter gives two words, so skipping 2 * position words moves to the counter position. We split that into two halves, because 2 * position may overflow.
+        const std::uint64_t position = join(v.counter[0], v.counter[1]);
+        
+        engine.discard( position );
+        engine.discard( position );
+        
+        const std::uint64_t word_0 = engine();
+        const std::uint64_t word_1 = engine();
+        
+        const bool matchQ = (word_0 == join(v.result[0], v.result[1])) && (word_1 == join(v.result[2], v.result[3]));
+        
+        if( !matchQ )
+        {
+            eprint("CheckPhiloxKnownAnswers: CoBarS::Philox4x32 does not reproduce the known answer for counter " + ToString(position) + ".");
+        }
+        
+        passedQ = passedQ && matchQ;
+    }
+    
+    print( std::string("CoBarS::Philox4x32 known-answer test: ") + (passedQ ? "passed" : "FAILED") );
+    
+    return passedQ;
+}
+
+// Compares the closed-form kernels from src/SymmetricKernels.hpp with the generic routines of Tiny::SelfAdjointMatrix on random positive-definite matrices, prints the greatest deviations, and returns whether they are all below tolerance. The condition numbers of the matrices stay below about 10^4, so tolerance leaves plenty of room for roundoff.
+template<int dim, typename Real, typename Int>
+bool CheckSymmetricKernels( const Int trial_count )
+{
+    const Real tolerance = Real(1000000) * std::numeric_limits<Real>::epsilon();
+    
+    using Matrix_T = Tiny::SelfAdjointMatrix<dim,Real,Int>;
+    using Vector_T = Tiny::Vector<dim,Real,Int>;
+    
+    std::mt19937_64 engine ( 12345 );
+    
+    std::normal_distribution<Real> dist;
+    
+    Real solve_error = 0;
+    Real det_error   = 0;
+    Real eig_error   = 0;
+    
+    for( Int trial = 0; trial < trial_count; ++trial )
+    {
+        // A = B B^T + 1/100 I is positive definite; its condition number varies over several orders of magnitude.
+        Real B [dim][dim];
+        
+        for( int i = 0; i < dim; ++i )
+        {
+            for( int j = 0; j < dim; ++j )
+            {
+                B[i][j] = dist(engine);
+            }
+        }
+        
+        Matrix_T A;
+        
+        Real A_norm = 0;
+        
+        for( int i = 0; i < dim; ++i )
+        {
+            for( int j = i; j < dim; ++j )
+            {
+                Real a = (i == j) ? Real(0.01) : Real(0);
+                
+                for( int k = 0; k < dim; ++k )
+                {
+                    a += B[i][k] * B[j][k];
+                }
+                
+                A[i][j] = a;
+                
+                A_norm = std::max( A_norm, std::abs(a) );
+            }
+        }
+        
+        Vector_T b;
+        
+        for( int i = 0; i < dim; ++i )
+        {
+            b[i] = dist(engine);
+        }
+        
+        Vector_T x;
+        Vector_T y;
+        
+        CoBarS::SymmetricSolve<dim,Real>( A, b, x );
+        
+        Matrix_T L = A;
+        
+        L.Cholesky();
+        
+        L.CholeskySolve( b, y );
+        
+        Real diff = 0;
+        Real size = 0;
+        
+        for( int i = 0; i < dim; ++i )
+        {
+            diff = std::max( diff, std::abs(x[i] - y[i]) );
+            size = std::max( size, std::abs(y[i]) );
+        }
+        
+        solve_error = std::max( solve_error, diff / size );
+        
+        const Real det = A.Det();
+        
+        det_error = std::max( det_error, std::abs( CoBarS::SymmetricDet<dim,Real>(A) - det ) / std::abs(det) );
+        
+        if constexpr ( dim <= 3 )
+        {
+            eig_error = std::max( eig_error, std::abs( CoBarS::SymmetricSmallestEigenvalue<dim,Real>(A) - A.SmallestEigenvalue() ) / A_norm );
+        }
+    }
+    
+    print("CoBarS::SymmetricKernels in dimension " + ToString(dim) + " vs. Tiny::SelfAdjointMatrix");
+    valprint( "  SymmetricSolve               (relative error)", solve_error );
+    valprint( "  SymmetricDet                 (relative error)", det_error   );
+    
+    if constexpr ( dim <= 3 )
+    {
+        valprint( "  SymmetricSmallestEigenvalue  (error / norm)  ", eig_error   );
+    }
+    
+    // The comparisons are written such that NaN fails.
+    const bool passedQ = (solve_error <= tolerance) && (det_error <= tolerance) && (eig_error <= tolerance);
+    
+    if( !passedQ )
+    {
+        eprint("CheckSymmetricKernels: Errors in dimension " + ToString(dim) + " exceed the tolerance " + ToString(tolerance) + ".");
+    }
+    
+    return passedQ;
+}
+
+// Closes the same random polygon with edge_count edges with polygon_thread_count = 1 and polygon_thread_count = thread_count and returns whether the vertex positions and the sampling weights agree up to roundoff. The threads reduce in a different order, so we cannot expect equality.
+template<int dim, typename Real, typename Int>
+bool CheckPolygonThreads( const Int edge_count, const Int thread_count )
+{
+    const Real tolerance = Real(1000000) * std::numeric_limits<Real>::epsilon();
+    
+    std::vector<Real> r ( edge_count );
+    
+    std::mt19937_64 engine ( 7 );
+    
+    std::uniform_real_distribution<Real> uniform ( Real(0.5), Real(2) );
+    
+    for( Real & r_i : r )
+    {
+        r_i = uniform(engine);
+    }
+    
+    CoBarS::SamplerSettings<Real,Int> settings;
+    
+    // The same seed for both runs, so that both close the same polygon.
+    settings.use_seed = true;
+    
+    CoBarS::Sampler<dim,Real,Int,Xoshiro256Plus> S_1 ( r.data(), r.data(), edge_count, settings );
+    
+    settings.polygon_thread_count = thread_count;
+    
+    CoBarS::Sampler<dim,Real,Int,Xoshiro256Plus> S_n ( r.data(), r.data(), edge_count, settings );
+    
+    S_1.RandomizeInitialEdgeVectors();
+    S_n.RandomizeInitialEdgeVectors();
+    
+    S_1.ComputeConformalClosure();
+    S_n.ComputeConformalClosure();
+    
+    Real diff = 0;
+    Real size = 0;
+    
+    for( Int k = 0; k <= edge_count; ++k )
+    {
+        const auto p_1 = S_1.VertexPosition(k);
+        const auto p_n = S_n.VertexPosition(k);
+        
+        for( int i = 0; i < dim; ++i )
+        {
+            diff = std::max( diff, std::abs(p_1[i] - p_n[i]) );
+            size = std::max( size, std::abs(p_1[i]) );
+        }
+    }
+    
+    const Real p_error = diff / size;
+    
+    const Real K_error = std::abs( S_1.EdgeQuotientSpaceSamplingLogWeight() - S_n.EdgeQuotientSpaceSamplingLogWeight() ) / std::max( Real(1), std::abs( S_1.EdgeQuotientSpaceSamplingLogWeight() ) );
+    
+    print("polygon_thread_count = 1 vs. " + ToString(thread_count) + " for a single polygon with " + ToString(edge_count) + " edges");
+    valprint( "  vertex positions  (relative error)", p_error );
+    valprint( "  log K             (relative error)", K_error );
+    
+    // The comparisons are written such that NaN fails.
+    const bool passedQ = (S_1.Residual() <= settings.tolerance) && (S_n.Residual() <= settings.tolerance) && (p_error <= tolerance) && (K_error <= tolerance);
+    
+    if( !passedQ )
+    {
+        eprint("CheckPolygonThreads: The results with polygon_thread_count = 1 and " + ToString(thread_count) + " do not agree up to the tolerance " + ToString(tolerance) + ".");
+    }
+    
+    return passedQ;
+}
+
+// In reproducible mode (SamplerSettings::use_seed), closed polygon k depends only on the seed, samples_per_stream, k, the edge lengths, and the pseudorandom number generator Prng_T. This generates sample_count polygons on one thread and checks that they are reproduced exactly by 8 threads, by dynamic scheduling, by the batch engine, and by ReplayClosedPolygons on a scattered list of indices.
+template<int dim, typename Real, typename Int, typename Prng_T>
+bool CheckReproducibility( const Int edge_count, const Int sample_count )
+{
+    using Sampler_T = CoBarS::Sampler<dim,Real,Int,Prng_T>;
+    
+    std::vector<Real> r ( edge_count );
+    
+    std::mt19937_64 engine ( 3 );
+    
+    std::uniform_real_distribution<Real> uniform ( Real(0.5), Real(2) );
+    
+    for( Real & r_i : r )
+    {
+        r_i = uniform(engine);
+    }
+    
+    CoBarS::SamplerSettings<Real,Int> settings;
+    
+    settings.use_seed = true;
+    settings.seed     = 20240611;
+    
+    // Small streams and chunks, so that the threads and chunks cross many stream boundaries.
+    settings.samples_per_stream    = 64;
+    settings.scheduling_chunk_size = 100;
+    
+    const Int q_size = (edge_count + 1) * dim;
+    
+    std::vector<Real> q_0 ( sample_count * q_size );
+    std::vector<Real> K_0 ( sample_count );
+    
+    Sampler_T( r.data(), r.data(), edge_count, settings ).CreateRandomClosedPolygons( q_0.data(), K_0.data(), sample_count, true, 1 );
+    
+    bool passedQ = true;
+    
+    auto check = [&]( const std::string & tag, const CoBarS::SamplerSettings<Real,Int> & variant, const Int thread_count )
+    {
+        std::vector<Real> q ( sample_count * q_size );
+        std::vector<Real> K ( sample_count );
+        
+        Sampler_T S ( r.data(), r.data(), edge_count, variant );
+        
+        S.CreateRandomClosedPolygons( q.data(), K.data(), sample_count, true, thread_count );
+        
+        if( (q != q_0) || (K != K_0) )
+        {
+            eprint("CheckReproducibility: " + S.ClassName() + " with " + tag + " does not reproduce the polygons of a single thread.");
+            
+            passedQ = false;
+        }
+    };
+    
+    check( "8 threads", settings, 8 );
+    
+    CoBarS::SamplerSettings<Real,Int> dynamic_settings ( settings );
+    
+    dynamic_settings.use_dynamic_scheduling = true;
+    
+    check( "dynamic scheduling", dynamic_settings, 8 );
+    
+    CoBarS::SamplerSettings<Real,Int> batch_settings ( settings );
+    
+    batch_settings.use_batch_engine = true;
+    
+    check( "the batch engine", batch_settings, 1 );
+    check( "the batch engine and 8 threads", batch_settings, 8 );
+    
+    // Unordered, with runs, repetitions, and jumps within and across streams.
+    const std::vector<Int> indices = {
+        sample_count - 1, 17, 18, 19, 0, 99, 100, 101, 250, sample_count / 2, sample_count / 2 + 1, 1, 1, 2, 63, 64, 65, 127
+    };
+    
+    const Int index_count = static_cast<Int>(indices.size());
+    
+    std::vector<Real> q ( index_count * q_size );
+    std::vector<Real> K ( index_count );
+    
+    Sampler_T S ( r.data(), r.data(), edge_count, settings );
+    
+    S.ReplayClosedPolygons( indices.data(), index_count, q.data(), nullptr, K.data(), 3 );
+    
+    for( Int j = 0; j < index_count; ++j )
+    {
+        const Int k = indices[j];
+        
+        if(
+            !std::equal( &q[q_size * j], &q[q_size * (j + 1)], &q_0[q_size * k] )
+            || (K[j] != K_0[k])
+        )
+        {
+            eprint("CheckReproducibility: " + S.ClassName() + "::ReplayClosedPolygons does not reproduce sample " + ToString(k) + ".");
+            
+            passedQ = false;
+        }
+    }
+    
+    print("Reproducibility of " + S.ClassName() + ": " + (passedQ ? "passed" : "FAILED"));
+    
+    return passedQ;
+}
+
+// Checks that CoBarS::BatchSampler (SamplerSettings::use_batch_engine) closes the same seeded polygons as the scalar Sampler: the open polygons, the shift vectors, the closed polygons' edge vectors and vertex positions, and both sampling weights have to agree exactly. In dimension 2, this covers the Möbius transformations of src/Sampler/Planar.hpp.
+template<int dim, typename Real, typename Int>
+bool CheckBatchEngine( const Int edge_count, const Int sample_count )
+{
+    using Sampler_T = CoBarS::Sampler<dim,Real,Int,Xoshiro256Plus>;
+    
+    std::vector<Real> r ( edge_count );
+    
+    std::mt19937_64 engine ( 5 );
+    
+    std::uniform_real_distribution<Real> uniform ( Real(0.5), Real(2) );
+    
+    for( Real & r_i : r )
+    {
+        r_i = uniform(engine);
+    }
+    
+    CoBarS::SamplerSettings<Real,Int> settings;
+    
+    settings.use_seed = true;
+    settings.seed     = 77;
+    
+    // The buffers of CreateRandomCentralizedPointClouds_Detailed and CreateRandomClosedPolygons.
+    struct Output
+    {
+        std::vector<Real> x;
+        std::vector<Real> w;
+        std::vector<Real> y;
+        std::vector<Real> K_edge;
+        std::vector<Real> K_quot;
+        std::vector<Real> q;
+        std::vector<Real> K;
+    };
+    
+    auto run = [&]( const bool batchQ )
+    {
+        CoBarS::SamplerSettings<Real,Int> s ( settings );
+        
+        s.use_batch_engine = batchQ;
+        
+        Sampler_T S ( r.data(), r.data(), edge_count, s );
+        
+        Output o {
+            std::vector<Real>( sample_count * edge_count * dim ),
+            std::vector<Real>( sample_count * dim ),
+            std::vector<Real>( sample_count * edge_count * dim ),
+            std::vector<Real>( sample_count ),
+            std::vector<Real>( sample_count ),
+            std::vector<Real>( sample_count * (edge_count + 1) * dim ),
+            std::vector<Real>( sample_count )
+        };
+        
+        S.CreateRandomCentralizedPointClouds_Detailed(
+            o.x.data(), o.w.data(), o.y.data(), o.K_edge.data(), o.K_quot.data(), sample_count, 1
+        );
+        
+        S.CreateRandomClosedPolygons( o.q.data(), o.K.data(), sample_count, true, 1 );
+        
+        return o;
+    };
+    
+    const Output scalar = run( false );
+    const Output batch  = run( true  );
+    
+    const bool passedQ = (scalar.x == batch.x) && (scalar.w == batch.w) && (scalar.y == batch.y)
+        && (scalar.K_edge == batch.K_edge) && (scalar.K_quot == batch.K_quot)
+        && (scalar.q == batch.q) && (scalar.K == batch.K);
+    
+    print("CoBarS::BatchSampler vs. CoBarS::Sampler in dimension " + ToString(dim) + ": " + (passedQ ? "passed" : "FAILED"));
+    
+    if( !passedQ )
+    {
+        eprint("CheckBatchEngine: The batch engine does not reproduce the scalar sampler in dimension " + ToString(dim) + ".");
+    }
+    
+    return passedQ;
+}
+
+// Strong scaling of SamplerSettings::polygon_thread_count: closes the same random polygon with edge_count edges with 1, 2, 4, ..., max_thread_count threads per polygon. Only the conformal closure is timed; the random edge vectors are drawn on a single thread anyway.
+template<int dim, typename Real, typename Int>
+void BenchmarkPolygonThreads( const Int edge_count, const Int max_thread_count )
+{
+    print("Strong scaling of polygon_thread_count for a single polygon with " + ToString(edge_count) + " edges");
+    
+    // Equilateral polygon.
+    std::vector<Real> r ( edge_count, Real(1) );
+    
+    Real t_1 = 0;
+    
+    for( Int thread_count = 1; thread_count <= max_thread_count; thread_count *= 2 )
+    {
+        CoBarS::SamplerSettings<Real,Int> settings;
+        
+        // The same seed for each run, so that all runs close the same polygon.
+        settings.use_seed = true;
+        
+        settings.polygon_thread_count = thread_count;
+        
+        CoBarS::Sampler<dim,Real,Int,Xoshiro256Plus> S ( r.data(), r.data(), edge_count, settings );
+        
+        S.RandomizeInitialEdgeVectors();
+        
+        Time start = Clock::now();
+        
+        S.ComputeConformalClosure();
+        
+        Time stop = Clock::now();
+        
+        const Real t = Tools::Duration(start, stop);
+        
+        if( thread_count == 1 )
+        {
+            t_1 = t;
+        }
+        
+        print("  polygon_thread_count = " + ToString(thread_count));
+        valprint( "    time [s]  ", t                                   );
+        valprint( "    speedup   ", t_1 / t                             );
+        valprint( "    iterations", S.IterationCount()                  );
+        valprint( "    log K     ", S.EdgeQuotientSpaceSamplingLogWeight() );
+    }
+}
+
+// The edge length distributions for the solver strategies: equilateral (0), uniformly distributed in [0.1,2] (1), and one edge as long as half of all others together (2).
+template<typename Real, typename Int>
+std::vector<Real> SolverTestEdgeLengths( const Int edge_count, const Int distribution )
+{
+    std::vector<Real> r ( edge_count, Real(1) );
+    
+    if( distribution == 1 )
+    {
+        std::mt19937_64 engine ( edge_count );
+        
+        std::uniform_real_distribution<Real> uniform ( Real(0.1), Real(2) );
+        
+        for( Real & r_i : r )
+        {
+            r_i = uniform(engine);
+        }
+    }
+    else if( distribution == 2 )
+    {
+        r[0] = Real(0.5) * static_cast<Real>(edge_count - 1);
+    }
+    
+    return r;
+}
+
+const std::string solver_test_distributions [] = { "equilateral", "uniform", "one long edge" };
+
+const CoBarS::SolverStrategy solver_strategies [] = {
+    CoBarS::SolverStrategy::Newton,
+    CoBarS::SolverStrategy::Newton_Residual,
+    CoBarS::SolverStrategy::Chebyshev,
+    CoBarS::SolverStrategy::TrustRegion,
+    CoBarS::SolverStrategy::Gradient_Hyperbolic,
+    CoBarS::SolverStrategy::Gradient_Planar
+};
+
+// Closes the same sample_count random polygons with each solver strategy, for each edge count and each distribution of edge lengths. Returns whether every strategy succeeds with residual below tolerance on every polygon and whether Chebyshev and TrustRegion find the same shift vector as Newton. The latter is the unique zero of a well-conditioned problem, so it may only differ by roundoff.
+template<int dim, typename Real, typename Int>
+bool CheckSolverStrategies( const std::vector<Int> & edge_counts, const Int sample_count )
+{
+    const Real w_tolerance = Real(1000000) * std::numeric_limits<Real>::epsilon();
+    
+    bool passedQ = true;
+    
+    Real w_error = 0;
+    
+    for( const Int edge_count : edge_counts )
+    {
+        for( Int distribution = 0; distribution < 3; ++distribution )
+        {
+            const std::vector<Real> r = SolverTestEdgeLengths<Real,Int>( edge_count, distribution );
+            
+            // The shift vectors of Newton's method, for comparison.
+            std::vector<Real> w_Newton ( sample_count * dim );
+            
+            for( const CoBarS::SolverStrategy strategy : solver_strategies )
+            {
+                CoBarS::SamplerSettings<Real,Int> settings;
+                
+                // The same seed for each strategy, so that all strategies close the same polygons.
+                settings.use_seed = true;
+                
+                settings.solver_strategy = strategy;
+                
+                // Steepest descent converges only linearly; on a few ill-conditioned polygons it needs more than the default number of iterations.
+                if( (strategy == CoBarS::SolverStrategy::Gradient_Hyperbolic) || (strategy == CoBarS::SolverStrategy::Gradient_Planar) )
+                {
+                    settings.max_iter = 100 * settings.max_iter;
+                }
+                
+                CoBarS::Sampler<dim,Real,Int,Xoshiro256Plus> S ( r.data(), r.data(), edge_count, settings );
+                
+                Int failures = 0;
+                
+                for( Int k = 0; k < sample_count; ++k )
+                {
+                    S.RandomizeInitialEdgeVectors();
+                    
+                    S.ComputeConformalClosure();
+                    
+                    // The comparison is written such that NaN fails.
+                    failures += !( S.SucceededQ() && (S.Residual() <= settings.tolerance) );
+                    
+                    const auto & w = S.ShiftVector();
+                    
+                    for( int i = 0; i < dim; ++i )
+                    {
+                        if( strategy == CoBarS::SolverStrategy::Newton )
+                        {
+                            w_Newton[dim * k + i] = w[i];
+                        }
+                        else if( (strategy == CoBarS::SolverStrategy::Chebyshev) || (strategy == CoBarS::SolverStrategy::TrustRegion) )
+                        {
+                            const Real diff = std::abs( w[i] - w_Newton[dim * k + i] );
+                            
+                            w_error = std::max( w_error, diff );
+                            
+                            if( !(diff <= w_tolerance) )
+                            {
+                                ++failures;
+                            }
+                        }
+                    }
+                }
+                
+                if( failures > 0 )
+                {
+                    eprint("CheckSolverStrategies: " + CoBarS::SolverStrategyName(strategy) + " failed on " + ToString(failures) + " of " + ToString(sample_count) + " polygons in dimension " + ToString(dim) + " with " + ToString(edge_count) + " edges (" + solver_test_distributions[distribution] + ").");
+                    
+                    passedQ = false;
+                }
+            }
+        }
+    }
+    
+    print("CoBarS::SolverStrategy in dimension " + ToString(dim) + ": " + (passedQ ? "passed" : "FAILED"));
+    valprint( "  Chebyshev, TrustRegion vs. Newton  (max shift vector error)", w_error );
+    
+    return passedQ;
+}
 
-int main()
+// Closes sample_count random polygons with one edge of length 0.9 * (edge_count - 1) with Newton_Residual and with Newton and returns whether Newton_Residual succeeds on each of them and finds the same shift vector. Here the backtracking of the line search on the squared residual is needed often; if it does not restart from the current point, some iterations end in NaN.
+template<int dim, typename Real, typename Int>
+bool CheckNewtonResidual( const Int edge_count, const Int sample_count )
+{
+    const Real w_tolerance = Real(1000000) * std::numeric_limits<Real>::epsilon();
+    
+    std::vector<Real> r ( edge_count, Real(1) );
+    
+    r[0] = Real(0.9) * static_cast<Real>(edge_count - 1);
+    
+    CoBarS::SamplerSettings<Real,Int> settings;
+    
+    // The same seed for both strategies, so that both close the same polygons.
+    settings.use_seed = true;
+    
+    settings.solver_strategy = CoBarS::SolverStrategy::Newton;
+    
+    CoBarS::Sampler<dim,Real,Int,Xoshiro256Plus> S_Newton ( r.data(), r.data(), edge_count, settings );
+    
+    settings.solver_strategy = CoBarS::SolverStrategy::Newton_Residual;
+    
+    CoBarS::Sampler<dim,Real,Int,Xoshiro256Plus> S ( r.data(), r.data(), edge_count, settings );
+    
+    Int failures = 0;
+    
+    Real w_error = 0;
+    
+    for( Int k = 0; k < sample_count; ++k )
+    {
+        S_Newton.RandomizeInitialEdgeVectors();
+        S.RandomizeInitialEdgeVectors();
+        
+        S_Newton.ComputeConformalClosure();
+        S.ComputeConformalClosure();
+        
+        Real diff = 0;
+        
+        for( int i = 0; i < dim; ++i )
+        {
+            diff = std::max( diff, std::abs( S.ShiftVector()[i] - S_Newton.ShiftVector()[i] ) );
+        }
+        
+        w_error = std::max( w_error, diff );
+        
+        // The comparisons are written such that NaN fails.
+        failures += !( S.SucceededQ() && (S.Residual() <= settings.tolerance) && (diff <= w_tolerance) );
+    }
+    
+    const bool passedQ = (failures == 0);
+    
+    print("Newton_Residual in dimension " + ToString(dim) + " with one long edge: " + (passedQ ? "passed" : "FAILED"));
+    valprint( "  vs. Newton  (max shift vector error)", w_error );
+    
+    if( !passedQ )
+    {
+        eprint("CheckNewtonResidual: Newton_Residual failed on " + ToString(failures) + " of " + ToString(sample_count) + " polygons.");
+    }
+    
+    return passedQ;
+}
+
+// Compares the solver strategies of SamplerSettings::solver_strategy: For each edge count and each distribution of edge lengths, closes the same sample_count random polygons with each strategy on a single thread and reports the mean number of iterations, the wall time per sample, and the number of polygons that did not converge.
+template<int dim, typename Real, typename Int>
+void BenchmarkSolverStrategies( const std::vector<Int> & edge_counts, const Int sample_count )
+{
+    print("Solver strategies in dimension " + ToString(dim));
+    
+    for( const Int edge_count : edge_counts )
+    {
+        for( Int distribution = 0; distribution < 3; ++distribution )
+        {
+            const std::vector<Real> r = SolverTestEdgeLengths<Real,Int>( edge_count, distribution );
+            
+            print("  edge_count = " + ToString(edge_count) + ", " + solver_test_distributions[distribution]);
+            
+            for( const CoBarS::SolverStrategy strategy : solver_strategies )
+            {
+                CoBarS::SamplerSettings<Real,Int> settings;
+                
+                // The same seed for each strategy, so that all strategies close the same polygons.
+                settings.use_seed = true;
+                
+                settings.solver_strategy = strategy;
+                
+                CoBarS::Sampler<dim,Real,Int,Xoshiro256Plus> S ( r.data(), r.data(), edge_count, settings );
+                
+                Int iterations = 0;
+                Int failures   = 0;
+                
+                Time start = Clock::now();
+                
+                for( Int k = 0; k < sample_count; ++k )
+                {
+                    S.RandomizeInitialEdgeVectors();
+                    
+                    S.ComputeConformalClosure();
+                    
+                    iterations += S.IterationCount();
+                    
+                    failures += (S.Residual() > settings.tolerance);
+                }
+                
+                Time stop = Clock::now();
+                
+                print("    " + CoBarS::SolverStrategyName(strategy));
+                valprint( "      iterations/sample", static_cast<Real>(iterations) / static_cast<Real>(sample_count) );
+                valprint( "      time/sample [s]  ", Tools::Duration(start, stop) / static_cast<Real>(sample_count) );
+                valprint( "      not converged    ", failures );
+            }
+        }
+    }
+}
+
+// Returns whether flag is among the command-line arguments.
+bool CommandLineFlagQ( const int argc, char ** argv, const std::string & flag )
+{
+    for( int i = 1; i < argc; ++i )
+    {
+        if( flag == argv[i] )
+        {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+int main( int argc, char ** argv )
 {
     print("Hello, this small test program compares the runtimes of CoBarS::Sampler with various settings to the Action Angle Method (AAM) and the Progressive Action Angle Method (PAAM). Moreover, I use it to detect compilation errors in all code paths.");
     
+    print("The long benchmarks are skipped by default. Pass --polygon-threads to run the strong scaling benchmark of polygon_thread_count and --solver-strategies to run the comparison of the solver strategies.");
+    
     using Real = double;
     using Int  = std::size_t;
 
@@ -66,7 +784,15 @@ int main()
     CoBarS::Sampler<d,Real,Int,Xoshiro256Plus,false,true >  S_Xoshiro_1     (edge_count);
     CoBarS::Sampler<d,Real,Int,Xoshiro256Plus,true ,false>  S_Xoshiro_vec_0 (edge_count);
     CoBarS::Sampler<d,Real,Int,Xoshiro256Plus,true ,true >  S_Xoshiro_vec_1 (edge_count);
+    
+    CoBarS::Sampler<d,Real,Int,Philox4x32,true ,false>      S_Philox_vec_0  (edge_count);
 
+    // The same, but with CoBarS::BatchSampler closing several polygons at once.
+    CoBarS::SamplerSettings<Real,Int> batch_settings;
+    batch_settings.use_batch_engine = true;
+    
+    CoBarS::Sampler<d,Real,Int,Xoshiro256Plus,true ,false>  S_Xoshiro_batch (edge_count, batch_settings);
+    CoBarS::Sampler<d,Real,Int,PCG64,true ,false>           S_PCG64_batch   (edge_count, batch_settings);
 
     
     // The boolean in the AAM::Sampler template stands for progressive (PAAM) or not (AAM).
@@ -83,6 +809,8 @@ int main()
     AAM::Sampler<Real,Int,Xoshiro256Plus,false> M_Xoshiro_0 (edge_count);
     AAM::Sampler<Real,Int,Xoshiro256Plus,true > M_Xoshiro_1 (edge_count);
     
+    AAM::Sampler<Real,Int,Philox4x32,true >     M_Philox_1  (edge_count);
+    
     
     // Create containers for the data samples.
     Tensor3<Real,Int> p ( sample_count, edge_count + 1, d ); // vertex positions of polygons.
@@ -99,15 +827,91 @@ int main()
     valprint("thread_count",thread_count);
     print("");
     
+    bool passedQ = true;
+    
+    passedQ = CheckPhiloxKnownAnswers() && passedQ;
+    
+    print("");
+    
+    passedQ = CheckSymmetricKernels<2,Real,Int>( 1000 ) && passedQ;
+    passedQ = CheckSymmetricKernels<3,Real,Int>( 1000 ) && passedQ;
+    passedQ = CheckSymmetricKernels<4,Real,Int>( 1000 ) && passedQ;
+    
+    print("");
+    
+    passedQ = CheckPolygonThreads<d,Real,Int>( 100000, 4 ) && passedQ;
+    
+    print("");
+    
+    passedQ = CheckReproducibility<d,Real,Int,MT64          >( 16, 1000 ) && passedQ;
+    passedQ = CheckReproducibility<d,Real,Int,PCG64         >( 16, 1000 ) && passedQ;
+    passedQ = CheckReproducibility<d,Real,Int,WyRand        >( 16, 1000 ) && passedQ;
+    passedQ = CheckReproducibility<d,Real,Int,Xoshiro256Plus>( 16, 1000 ) && passedQ;
+    passedQ = CheckReproducibility<d,Real,Int,Philox4x32    >( 16, 1000 ) && passedQ;
+    
+    passedQ = CheckBatchEngine<2,Real,Int>( 16, 1000 ) && passedQ;
+    passedQ = CheckBatchEngine<3,Real,Int>( 16, 1000 ) && passedQ;
+    
+    print("");
+    
+    passedQ = CheckSolverStrategies<2,Real,Int>( { 8, 64 }, 100 ) && passedQ;
+    passedQ = CheckSolverStrategies<3,Real,Int>( { 8, 64 }, 100 ) && passedQ;
+    passedQ = CheckSolverStrategies<4,Real,Int>( { 8, 64 }, 100 ) && passedQ;
+    
+    passedQ = CheckNewtonResidual<3,Real,Int>( 8, 1000 ) && passedQ;
+    
+    print("");
+    
     auto run_CoBarS = [&p,&K,sample_count,quot_space_Q,thread_count]( auto & S )
     {
-        tic(S.ClassName());
+        const std::string tag = S.ClassName() + (S.Settings().use_batch_engine ? " (batch)" : "");
+        
+        tic(tag);
+        
+        Time start = Clock::now();
         
         S.CreateRandomClosedPolygons(
             p.data(), K.data(), sample_count, quot_space_Q, thread_count
         );
         
-        toc(S.ClassName());
+        Time stop = Clock::now();
+        
+        toc(tag);
+        
+        valprint( "samples/sec", static_cast<Real>(sample_count) / Tools::Duration(start, stop) );
+    };
+    
+    // Single-threaded comparison of the block generator for the initial edge vectors with the original one-vector-at-a-time generator.
+    auto run_RandomizeInitialEdgeVectors = [sample_count]( auto & S )
+    {
+        const Int repetitions = sample_count / 10;
+        
+        Time start = Clock::now();
+        
+        for( Int k = 0; k < repetitions; ++k )
+        {
+            S.RandomizeInitialEdgeVectors_Gaussian();
+        }
+        
+        Time stop = Clock::now();
+        
+        const Real t_gaussian = Tools::Duration(start, stop);
+        
+        start = Clock::now();
+        
+        for( Int k = 0; k < repetitions; ++k )
+        {
+            S.RandomizeInitialEdgeVectors();
+        }
+        
+        stop = Clock::now();
+        
+        const Real t_block = Tools::Duration(start, stop);
+        
+        print(S.ClassName() + "::RandomizeInitialEdgeVectors");
+        valprint( "  Gaussian [polygons/sec]", static_cast<Real>(repetitions) / t_gaussian );
+        valprint( "  block    [polygons/sec]", static_cast<Real>(repetitions) / t_block    );
+        valprint( "  speedup                ", t_gaussian / t_block                        );
     };
     
     auto run_AAM = [&p,sample_count,thread_count]( auto & S )
@@ -150,6 +954,43 @@ int main()
 
     print("");
     
+    run_CoBarS(S_Philox_vec_0);
+    
+    print("");
+    
+    // Scalar path vs. batch path.
+    run_CoBarS(S_PCG64_vec_0);
+    run_CoBarS(S_PCG64_batch);
+    run_CoBarS(S_Xoshiro_vec_0);
+    run_CoBarS(S_Xoshiro_batch);
+    
+    print("");
+    
+    run_RandomizeInitialEdgeVectors(S_MT_vec_0);
+    run_RandomizeInitialEdgeVectors(S_PCG64_vec_0);
+    run_RandomizeInitialEdgeVectors(S_WyRand_vec_0);
+    run_RandomizeInitialEdgeVectors(S_Xoshiro_vec_0);
+    run_RandomizeInitialEdgeVectors(S_Philox_vec_0);
+    
+    print("");
+    
+    // This needs about 1 GB of memory and several minutes.
+    if( CommandLineFlagQ( argc, argv, "--polygon-threads" ) )
+    {
+        BenchmarkPolygonThreads<d,Real,Int>( 10000000, thread_count );
+        
+        print("");
+    }
+    
+    if( CommandLineFlagQ( argc, argv, "--solver-strategies" ) )
+    {
+        BenchmarkSolverStrategies<2,Real,Int>( { 8, 32, 256, 4096 }, 10000 );
+        BenchmarkSolverStrategies<3,Real,Int>( { 8, 32, 256, 4096 }, 10000 );
+        BenchmarkSolverStrategies<4,Real,Int>( { 8, 32, 256, 4096 }, 10000 );
+        
+        print("");
+    }
+    
 //    run_AAM(M_MT64_0);
 //    run_AAM(M_MT64_1);
 //    
@@ -167,6 +1008,7 @@ int main()
 
     run_AAM(M_Xoshiro_0);
     run_AAM(M_Xoshiro_1);
+    run_AAM(M_Philox_1);
 
-    return 0;
+    return passedQ ? 0 : 1;
 }
@@ -16,6 +16,7 @@ namespace AAM
      * Possible values are
      *  - CoBarS::MT64
      *  - CoBarS::PCG64
+     *  - CoBarS::Philox4x32
      *  - CoBarS::WyRand
      *  - CoBarS::Xoshiro256Plus
      *
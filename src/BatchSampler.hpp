@@ -0,0 +1,1005 @@
+#pragma once
+
+namespace CoBarS
+{
+
+/*!
+ * @brief Computes the conformal closures of `LANES` random open polygons at once.
+ *
+ * The state of the `LANES` polygons (edge vectors, shift vectors, gradients, Hessians) is stored with the lane index running fastest, so that the O(`edge_count`) passes of the Newton iteration (shift, gradient/Hessian assembly, potential evaluation) can be vectorized across polygons. Each lane is masked out once its polygon has converged; the remaining lanes continue to iterate.
+ *
+ * The O(`AMB_DIM`^3) linear algebra (Cholesky factorization, smallest eigenvalue) is done lane by lane. Afterwards, each lane can be loaded into an instance of `CoBarS::Sampler` with `LoadLane`, which also computes the vertex positions and sampling weights, so that random variables can be evaluated on it.
+ *
+ * @tparam AMB_DIM The dimension of the ambient space.
+ *
+ * @tparam REAL A real floating point type.
+ *
+ * @tparam INT  An integer type.
+ *
+ * @tparam PRNG_T A class of a pseudorandom number generator.
+ *
+ * @tparam LANES The number of polygons processed simultaneously. Best choose the number of `REAL`s that fit into a SIMD register, i.e., `4` for `double` and `8` for `float` on AVX2 machines.
+ */
+
+    template<
+        int AMB_DIM,
+        typename REAL    = double,
+        typename INT     = std::size_t,
+        typename PRNG_T  = Xoshiro256Plus,
+        int LANES        = 4
+    >
+    class BatchSampler
+    {
+        static_assert(FloatQ<REAL>,"");
+        static_assert(Scalar::RealQ<REAL>,"");
+        static_assert(IntQ<INT>,"");
+        static_assert(LANES > 0,"");
+
+    public:
+
+        using Real   = REAL;
+        using Int    = INT;
+        using Prng_T = PRNG_T;
+
+        static constexpr Int AmbDim = int_cast<Int>(AMB_DIM);
+        static constexpr Int Lanes  = int_cast<Int>(LANES);
+
+        using Sampler_T         = Sampler<AMB_DIM,Real,Int,Prng_T,true,false>;
+
+        using Vector_T          = typename Sampler_T::Vector_T;
+        using SymmetricMatrix_T = typename Sampler_T::SymmetricMatrix_T;
+        using Weights_T         = typename Sampler_T::Weights_T;
+        using Setting_T         = typename Sampler_T::Setting_T;
+
+        // Coordinate j of edge i in lane l is stored in x_(i,j,l).
+        using LaneVectorList_T  = Tensor3<Real,Int>;
+
+        BatchSampler() = default;
+
+        ~BatchSampler() = default;
+
+        explicit BatchSampler(
+            const Int edge_count,
+            const Setting_T settings = Setting_T()
+        )
+        :   settings_   ( settings )
+        ,   edge_count_ ( edge_count )
+        ,   random_engine ( Sampler_T::InitialRandomEngine( settings ) )
+        ,   random_buffer_ ( RandomUnitVectorsBufferSize<AmbDim>(edge_count_) )
+        ,   r_          ( edge_count_, one )
+        ,   rho_        ( edge_count_, one )
+        ,   total_r_inv ( Inv<Real>( edge_count_ ) )
+        ,   x_          ( edge_count_, AmbDim, Lanes )
+        ,   y_          ( edge_count_, AmbDim, Lanes )
+        ,   y_dot_u_    ( edge_count_, Lanes )
+        {}
+
+        explicit BatchSampler(
+            const Real * restrict const r,
+            const Real * restrict const rho,
+            const Int edge_count,
+            const Setting_T settings = Setting_T()
+        )
+        :   settings_   ( settings )
+        ,   edge_count_ ( edge_count )
+        ,   random_engine ( Sampler_T::InitialRandomEngine( settings ) )
+        ,   random_buffer_ ( RandomUnitVectorsBufferSize<AmbDim>(edge_count_) )
+        ,   r_          ( r,   edge_count_ )
+        ,   rho_        ( rho, edge_count_ )
+        ,   total_r_inv ( Inv( r_.Total() ) )
+        ,   x_          ( edge_count_, AmbDim, Lanes )
+        ,   y_          ( edge_count_, AmbDim, Lanes )
+        ,   y_dot_u_    ( edge_count_, Lanes )
+        {
+            for( Int i = 0; i < edge_count_; ++i )
+            {
+                equilateralQ = equilateralQ && (r_[i] == r_[0]);
+            }
+        }
+
+    private:
+
+        Setting_T settings_;
+
+        Int edge_count_ = 0;
+
+        mutable Prng_T random_engine;
+
+        Tensor1<Real,Int> random_buffer_;
+
+        Weights_T r_   {0};
+
+        Weights_T rho_ {0};
+
+        Real total_r_inv = one;
+
+        bool equilateralQ = true;
+
+        /*!
+         * @brief The open polylines' unit edge vectors.
+         */
+
+        LaneVectorList_T x_;
+
+        /*!
+         * @brief The shifted polylines' unit edge vectors.
+         */
+
+        LaneVectorList_T y_;
+
+        // The dot products of y_ with u_, cached by the line search; see Sampler::PotentialAndRayDots.
+        Tensor2<Real,Int> y_dot_u_;
+
+        // Per-lane state. The lane index runs fastest.
+
+        Real w_  [AmbDim][Lanes];
+        Real F_  [AmbDim][Lanes];
+        Real DF_ [AmbDim][AmbDim][Lanes]; // Only the upper triangle is used.
+        Real u_  [AmbDim][Lanes];
+        Real z_  [AmbDim][Lanes];
+
+        // z_ = step * u_ during the line search.
+        Real step [Lanes];
+
+        Real potential        [Lanes];
+        Real squared_residual [Lanes];
+        Real residual         [Lanes];
+        Real lambda_min       [Lanes];
+        Real q_Newton         [Lanes];
+        Real errorestimator   [Lanes];
+
+        Int  iter             [Lanes];
+
+        bool linesearchQ      [Lanes];
+        bool succeededQ       [Lanes];
+        bool continueQ        [Lanes];
+        bool ArmijoQ          [Lanes];
+
+    private:
+
+        static constexpr Real zero              = 0;
+        static constexpr Real half              = 0.5;
+        static constexpr Real one               = 1;
+        static constexpr Real two               = 2;
+        static constexpr Real four              = 4;
+        static constexpr Real eps               = std::numeric_limits<Real>::min();
+        static constexpr Real infty             = std::numeric_limits<Real>::max();
+        static constexpr Real big_one           = 1 + 16 * eps;
+        static constexpr Real g_factor          = 4;
+        static constexpr Real norm_threshold    = 0.99 * 0.99 + 16 * eps;
+
+    public:
+
+        const Setting_T & Settings() const
+        {
+            return settings_;
+        }
+
+        Int EdgeCount() const
+        {
+            return edge_count_;
+        }
+
+        const Weights_T & EdgeLengths() const
+        {
+            return r_;
+        }
+
+        const Weights_T & Rho() const
+        {
+            return rho_;
+        }
+
+        Int IterationCount( const Int l ) const
+        {
+            return iter[l];
+        }
+
+        Real Residual( const Int l ) const
+        {
+            return residual[l];
+        }
+
+        Real ErrorEstimator( const Int l ) const
+        {
+            return errorestimator[l];
+        }
+
+        /*!
+         * @brief Fills the first `lane_count` lanes with random open polygons. The lanes are filled one after another, each from `RandomUnitVectorsBufferSize<AmbDim>(EdgeCount())` consecutive words of the random engine; this is the same as for `CoBarS::Sampler`.
+         */
+
+        void RandomizeInitialEdgeVectors( const Int lane_count = Lanes )
+        {
+
+            for( Int l = 0; l < lane_count; ++l )
+            {
+                RandomUnitVectors<AmbDim>(
+                    random_engine, random_buffer_.data(), edge_count_,
+                    [this,l]( const Int i, const Int j, const Real value )
+                    {
+                        x_(i,j,l) = value;
+                    }
+                );
+            }
+            
+            // The remaining lanes get copies, so that they do not cause any extra iterations.
+            for( Int l = lane_count; l < Lanes; ++l )
+            {
+                for( Int i = 0; i < edge_count_; ++i )
+                {
+                    for( Int j = 0; j < AmbDim; ++j )
+                    {
+                        x_(i,j,l) = x_(i,j,lane_count-1);
+                    }
+                }
+            }
+        }
+
+        /*!
+         * @brief Like `RandomizeInitialEdgeVectors`, but lane `l` gets the sample with index `k + l` of the scrambled Sobol sequences `qmc`; see `CoBarS::Sampler::QuasiRandomizeInitialEdgeVectors`.
+         */
+
+        void QuasiRandomizeInitialEdgeVectors( const ScrambledSobol & qmc, const Int k, const Int lane_count = Lanes )
+        {
+            for( Int l = 0; l < lane_count; ++l )
+            {
+                qmc.Sample( k + l, random_buffer_.data() );
+
+                UniformsToUnitVectors<AmbDim>(
+                    random_buffer_.data(), edge_count_,
+                    [this,l]( const Int i, const Int j, const Real value )
+                    {
+                        x_(i,j,l) = value;
+                    }
+                );
+            }
+
+            for( Int l = lane_count; l < Lanes; ++l )
+            {
+                for( Int i = 0; i < edge_count_; ++i )
+                {
+                    for( Int j = 0; j < AmbDim; ++j )
+                    {
+                        x_(i,j,l) = x_(i,j,lane_count-1);
+                    }
+                }
+            }
+        }
+
+        Prng_T & RandomEngine()
+        {
+            return random_engine;
+        }
+
+        /*!
+         * @brief Reads the open polygon for lane `l` from the buffer `x`. The layout is the same as in `CoBarS::Sampler::ReadInitialEdgeVectors`.
+         */
+
+        void ReadInitialEdgeVectors(
+            const Real * restrict const x, const Int offset, const Int l
+        )
+        {
+            cptr<Real> X = &x[AmbDim * edge_count_ * offset];
+
+            for( Int i = 0; i < edge_count_; ++i )
+            {
+                Vector_T x_i ( X, i );
+
+                x_i.Normalize();
+
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    x_(i,j,l) = x_i[j];
+                }
+            }
+        }
+
+        /*!
+         * @brief Runs the Newton-like algorithm of `CoBarS::Sampler` on all lanes simultaneously. A lane is masked out as soon as its polygon has converged.
+         */
+
+        void ComputeConformalClosures()
+        {
+            ComputeInitialShiftVectors();
+
+            Optimize();
+        }
+
+        /*!
+         * @brief Copies the result of lane `l` into `S` and computes the vertex positions and sampling weights there, so that random variables can be evaluated on `S`. `S` has to have the same edge lengths and the same `rho` as this object.
+         */
+
+        template<bool vertex_pos_Q = true, bool quot_space_Q = true, typename T>
+        void LoadLane( const Int l, T & S ) const
+        {
+            for( Int i = 0; i < edge_count_; ++i )
+            {
+                Vector_T v;
+
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    v[j] = x_(i,j,l);
+                }
+
+                T::SetVector( v, S.x_, i );
+
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    v[j] = y_(i,j,l);
+                }
+
+                T::SetVector( v, S.y_, i );
+            }
+
+            for( Int j = 0; j < AmbDim; ++j )
+            {
+                S.w_[j] = w_[j][l];
+            }
+
+            S.iter             = iter[l];
+            S.squared_residual = squared_residual[l];
+            S.residual         = residual[l];
+            S.lambda_min       = lambda_min[l];
+            S.q_Newton         = q_Newton[l];
+            S.errorestimator   = errorestimator[l];
+            S.succeededQ       = succeededQ[l];
+
+            S.template computeSamplingWeights<vertex_pos_Q,quot_space_Q>();
+        }
+
+    private:
+
+        bool AnyActiveQ() const
+        {
+            bool result = false;
+
+            for( Int l = 0; l < Lanes; ++l )
+            {
+                result = result || continueQ[l];
+            }
+
+            return result;
+        }
+
+        void ComputeInitialShiftVectors()
+        {
+            for( Int j = 0; j < AmbDim; ++j )
+            {
+                for( Int l = 0; l < Lanes; ++l )
+                {
+                    w_[j][l] = zero;
+                }
+            }
+
+            for( Int i = 0; i < edge_count_; ++i )
+            {
+                const Real r_i = r_[i];
+
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    cptr<Real> x_ij = &x_(i,j,0);
+
+                    for( Int l = 0; l < Lanes; ++l )
+                    {
+                        w_[j][l] += x_ij[l] * r_i;
+                    }
+                }
+            }
+
+            for( Int j = 0; j < AmbDim; ++j )
+            {
+                for( Int l = 0; l < Lanes; ++l )
+                {
+                    w_[j][l] *= total_r_inv;
+                }
+            }
+        }
+
+        void Optimize()
+        {
+            const Int max_iter = Settings().max_iter;
+
+            for( Int l = 0; l < Lanes; ++l )
+            {
+                iter[l]       = 0;
+                continueQ[l]  = true;
+                succeededQ[l] = false;
+            }
+
+            Shift();
+
+            DifferentialAndHessian_Hyperbolic();
+
+            SearchDirection_Hyperbolic();
+
+            Int iteration = 0;
+
+            // The main loop.
+            while( ( iteration < max_iter ) && AnyActiveQ() )
+            {
+                ++iteration;
+
+                for( Int l = 0; l < Lanes; ++l )
+                {
+                    iter[l] += static_cast<Int>(continueQ[l]);
+                }
+
+                LineSearch_Hyperbolic_Potential();
+
+                DifferentialAndHessian_Hyperbolic();
+
+                SearchDirection_Hyperbolic();
+            }
+        }
+
+        void RayDots()
+        {
+            for( Int i = 0; i < edge_count_; ++i )
+            {
+                Real yu [Lanes] = {};
+
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    cptr<Real> y_ij = &y_(i,j,0);
+
+                    for( Int l = 0; l < Lanes; ++l )
+                    {
+                        yu[l] += y_ij[l] * u_[j][l];
+                    }
+                }
+
+                for( Int l = 0; l < Lanes; ++l )
+                {
+                    y_dot_u_(i,l) = yu[l];
+                }
+            }
+        }
+
+        void Potential()
+        {
+            // Evaluates the potential at z_ = step * u_ for all lanes at once from the dot products cached by RayDots, in the same order of operations as Sampler::rayPotential.
+
+            Real a     [Lanes];
+            Real two_s [Lanes];
+            Real log_c [Lanes];
+
+            for( Int l = 0; l < Lanes; ++l )
+            {
+                Real uu = zero;
+
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    uu += u_[j][l] * u_[j][l];
+                }
+
+                const Real zz = step[l] * step[l] * uu;
+
+                a[l]     = big_one + zz;
+                two_s[l] = two * step[l];
+                log_c[l] = std::log( std::abs( big_one - zz ) );
+
+                potential[l] = zero;
+            }
+
+            if( equilateralQ )
+            {
+                constexpr Int lane_count = static_cast<Int>(Sampler_T::BatchLanes);
+                constexpr Int chunk_size = lane_count * Sampler_T::ProductBlockSize;
+
+                for( Int i_0 = 0; i_0 < edge_count_; i_0 += chunk_size )
+                {
+                    Real prod [lane_count][Lanes];
+
+                    for( Int k = 0; k < lane_count; ++k )
+                    {
+                        for( Int l = 0; l < Lanes; ++l )
+                        {
+                            prod[k][l] = one;
+                        }
+                    }
+
+                    const Int i_1 = std::min( i_0 + chunk_size, edge_count_ );
+
+                    for( Int i = i_0; i < i_1; ++i )
+                    {
+                        mptr<Real> prod_i = &prod[(i - i_0) % lane_count][0];
+
+                        for( Int l = 0; l < Lanes; ++l )
+                        {
+                            prod_i[l] *= a[l] - two_s[l] * y_dot_u_(i,l);
+                        }
+                    }
+
+                    for( Int k = 0; k < lane_count; ++k )
+                    {
+                        for( Int l = 0; l < Lanes; ++l )
+                        {
+                            potential[l] += std::log( std::abs( prod[k][l] ) );
+                        }
+                    }
+                }
+
+                for( Int l = 0; l < Lanes; ++l )
+                {
+                    potential[l] = potential[l] * Inv<Real>( edge_count_ ) - log_c[l];
+                }
+            }
+            else
+            {
+                for( Int i = 0; i < edge_count_; ++i )
+                {
+                    const Real r_i = r_[i];
+
+                    for( Int l = 0; l < Lanes; ++l )
+                    {
+                        potential[l] += r_i * std::log( std::abs( a[l] - two_s[l] * y_dot_u_(i,l) ) );
+                    }
+                }
+
+                for( Int l = 0; l < Lanes; ++l )
+                {
+                    potential[l] = potential[l] * total_r_inv - log_c[l];
+                }
+            }
+        }
+
+        void SetStep( const Int l, const Real tau, const Real u_norm )
+        {
+            step[l] = tau * Sampler_T::tanhc(tau * u_norm);
+
+            for( Int j = 0; j < AmbDim; ++j )
+            {
+                z_[j][l] = step[l] * u_[j][l];
+            }
+        }
+
+        void LineSearch_Hyperbolic_Potential()
+        {
+            const Real gamma = Settings().Armijo_shrink_factor;
+
+            const Real sigma = Settings().Armijo_slope_factor;
+
+            Real tau    [Lanes];
+            Real u_norm [Lanes];
+            Real Dphi_0 [Lanes];
+
+            bool searchQ = false;
+
+            for( Int l = 0; l < Lanes; ++l )
+            {
+                tau[l] = continueQ[l] ? one : zero;
+
+                Real uu = zero;
+                Real Fu = zero;
+
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    uu += u_[j][l] * u_[j][l];
+                    Fu += F_[j][l] * u_[j][l];
+                }
+
+                u_norm[l] = std::sqrt(uu);
+                Dphi_0[l] = g_factor * Fu;
+
+                // exponential map shooting from 0 to tau * u_.
+                SetStep( l, tau[l], u_norm[l] );
+
+                // Lanes that have converged or that do not use line search are already done.
+                ArmijoQ[l] = !( continueQ[l] && linesearchQ[l] );
+
+                searchQ = searchQ || !ArmijoQ[l];
+            }
+
+            if( searchQ )
+            {
+                //Linesearch with potential as merit function. The backtracking steps need only the dot products cached by RayDots.
+
+                RayDots();
+
+                Potential();
+
+                bool doneQ = true;
+
+                for( Int l = 0; l < Lanes; ++l )
+                {
+                    ArmijoQ[l] = ArmijoQ[l] || ( potential[l] - sigma * tau[l] * Dphi_0[l] < zero );
+
+                    doneQ = doneQ && ArmijoQ[l];
+                }
+
+                Int backtrackings = 0;
+
+                while( !doneQ && (backtrackings < Settings().max_backtrackings) )
+                {
+                    ++backtrackings;
+
+                    for( Int l = 0; l < Lanes; ++l )
+                    {
+                        if( !ArmijoQ[l] )
+                        {
+                            const Real tau_1 = gamma * tau[l];
+
+                            // Estimate step size from quadratic fit if applicable.
+                            const Real tau_2 = - half * sigma * tau[l] * tau[l] * Dphi_0[l] / ( potential[l] - tau[l] * Dphi_0[l] );
+
+                            tau[l] = std::max( tau_1, tau_2 );
+
+                            SetStep( l, tau[l], u_norm[l] );
+                        }
+                    }
+
+                    Potential();
+
+                    doneQ = true;
+
+                    for( Int l = 0; l < Lanes; ++l )
+                    {
+                        ArmijoQ[l] = ArmijoQ[l] || ( potential[l] - sigma * tau[l] * Dphi_0[l] < zero );
+
+                        doneQ = doneQ && ArmijoQ[l];
+                    }
+                }
+            }
+
+            // Shift the points z_ along -w_ to get new updated points w_.
+            InverseShift();
+
+            // Shift the input measures along w_ to 0 to simplify gradient, Hessian, and update computation .
+            Shift();
+        }
+
+        void DifferentialAndHessian_Hyperbolic()
+        {
+            // CAUTION: We use a different sign convention as in the paper!
+            // See CoBarS::Sampler::DifferentialAndHessian_Hyperbolic.
+
+            for( Int j = 0; j < AmbDim; ++j )
+            {
+                for( Int l = 0; l < Lanes; ++l )
+                {
+                    F_[j][l] = zero;
+                }
+
+                for( Int k = j; k < AmbDim; ++k )
+                {
+                    for( Int l = 0; l < Lanes; ++l )
+                    {
+                        DF_[j][k][l] = zero;
+                    }
+                }
+            }
+
+            for( Int i = 0; i < edge_count_; ++i )
+            {
+                const Real r_i = r_[i];
+
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    cptr<Real> y_ij = &y_(i,j,0);
+
+                    Real factor [Lanes];
+
+                    for( Int l = 0; l < Lanes; ++l )
+                    {
+                        factor[l] = r_i * y_ij[l];
+
+                        F_[j][l] -= factor[l];
+                    }
+
+                    for( Int k = j; k < AmbDim; ++k )
+                    {
+                        cptr<Real> y_ik = &y_(i,k,0);
+
+                        for( Int l = 0; l < Lanes; ++l )
+                        {
+                            DF_[j][k][l] -= factor[l] * y_ik[l];
+                        }
+                    }
+                }
+            }
+
+            for( Int l = 0; l < Lanes; ++l )
+            {
+                Real FF = zero;
+
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    // Normalize for case that the weights in r do not sum to 1.
+                    F_[j][l] *= total_r_inv;
+
+                    FF += F_[j][l] * F_[j][l];
+
+                    F_[j][l] *= half;
+
+                    for( Int k = j; k < AmbDim; ++k )
+                    {
+                        DF_[j][k][l] *= total_r_inv;
+                    }
+
+                    // Better add the identity afterwards for precision reasons.
+                    DF_[j][j][l] += one;
+                }
+
+                squared_residual[l] = FF;
+
+                residual[l] = std::sqrt( FF );
+            }
+        }
+
+        void SearchDirection_Hyperbolic()
+        {
+            // The decisions and the linear algebra are done lane by lane, exactly as in CoBarS::Sampler::SearchDirection_Hyperbolic.
+
+            for( Int l = 0; l < Lanes; ++l )
+            {
+                if( !continueQ[l] )
+                {
+                    // Converged lanes keep their state.
+                    for( Int j = 0; j < AmbDim; ++j )
+                    {
+                        u_[j][l] = zero;
+                    }
+
+                    continue;
+                }
+
+                SymmetricMatrix_T DF;
+
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    for( Int k = j; k < AmbDim; ++k )
+                    {
+                        DF[j][k] = DF_[j][k][l];
+                    }
+                }
+
+                if( residual[l] < static_cast<Real>(100.) * Settings().tolerance )
+                {
+                    // We have to compute eigenvalue _before_ we add the regularization.
+
+                    if constexpr ( (AmbDim == 2) || (AmbDim == 3) )
+                    {
+                        lambda_min[l] = SymmetricSmallestEigenvalue<AmbDim,Real>( DF );
+                    }
+                    else
+                    {
+                        lambda_min[l] = DF.SmallestEigenvalue();
+                    }
+
+                    q_Newton[l] = four * residual[l] / (lambda_min[l] * lambda_min[l]);
+
+                    if( q_Newton[l] < one )
+                    {
+                        //Kantorovich condition satisfied; this allows to compute an error estimator.
+                        errorestimator[l] = half * lambda_min[l] * q_Newton[l];
+                        //And we should deactivate line search. Otherwise, we may run into precision issues.
+                        linesearchQ[l] = false;
+                        continueQ[l] = (errorestimator[l] > Settings().tolerance);
+                        succeededQ[l] = !continueQ[l];
+                    }
+                    else
+                    {
+                        errorestimator[l] = infty;
+                        linesearchQ[l] = Settings().Armijo_slope_factor > zero;
+                        continueQ[l] = residual[l] > Settings().give_up_tolerance;
+                    }
+                }
+                else
+                {
+                    q_Newton[l] = big_one;
+                    lambda_min[l] = eps;
+                    errorestimator[l] = infty;
+                    linesearchQ[l] = Settings().Armijo_slope_factor > zero;
+                    continueQ[l] = residual[l] > std::max( Settings().give_up_tolerance, Settings().tolerance );
+                }
+
+                const Real c = Settings().regularization * squared_residual[l];
+
+                SymmetricMatrix_T L;
+
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    for( Int k = j; k < AmbDim; ++k )
+                    {
+                        L[j][k] = DF[j][k] + static_cast<Real>(j==k) * c;
+                    }
+                }
+
+                Vector_T F;
+                Vector_T u;
+
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    F[j] = F_[j][l];
+                }
+
+                if constexpr ( SymmetricKernelsQ<AmbDim> )
+                {
+                    SymmetricSolve<AmbDim,Real>( L, F, u );
+                }
+                else
+                {
+                    L.Cholesky();
+
+                    L.CholeskySolve(F,u);
+                }
+
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    u_[j][l] = -u[j];
+                }
+            }
+        }
+
+        void InverseShift()
+        {
+            // Shifts just the points w_; lanes that have converged are left untouched.
+
+            for( Int l = 0; l < Lanes; ++l )
+            {
+                if( !continueQ[l] )
+                {
+                    continue;
+                }
+
+                if constexpr ( AmbDim == 2 )
+                {
+                    Sampler_T::MoebiusInverseShift_Planar( w_[0][l], w_[1][l], z_[0][l], z_[1][l] );
+
+                    continue;
+                }
+
+                Real ww  = zero;
+                Real wz2 = zero;
+                Real zz  = zero;
+
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    ww  += w_[j][l] * w_[j][l];
+                    wz2 += w_[j][l] * z_[j][l];
+                    zz  += z_[j][l] * z_[j][l];
+                }
+
+                wz2 *= two;
+
+                const Real d = one / (big_one + wz2 + ww * zz);
+
+                const Real a = (one - ww) * d;
+                const Real b = (one + zz + wz2) * d;
+
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    w_[j][l] = a * z_[j][l] + b * w_[j][l];
+                }
+            }
+        }
+
+        void Shift()
+        {
+            // Shifts all entries of x along w and writes the results to y -- for all lanes at once.
+
+            Real one_minus_ww [Lanes];
+            Real one_plus_ww  [Lanes];
+
+            // Lanes with w close to the boundary of the ball get normalized output.
+            Real normalize    [Lanes];
+
+            for( Int l = 0; l < Lanes; ++l )
+            {
+                Real ww = zero;
+
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    ww += w_[j][l] * w_[j][l];
+                }
+
+                one_minus_ww[l] = big_one - ww;
+                one_plus_ww [l] = big_one + ww;
+                normalize   [l] = static_cast<Real>( ww > norm_threshold );
+            }
+
+            // Only needed for AmbDim == 2: the squares of the w_ as complex numbers.
+            Real w2_re [Lanes];
+            Real w2_im [Lanes];
+
+            if constexpr ( AmbDim == 2 )
+            {
+                for( Int l = 0; l < Lanes; ++l )
+                {
+                    w2_re[l] = w_[0][l] * w_[0][l] - w_[1][l] * w_[1][l];
+                    w2_im[l] = two * w_[0][l] * w_[1][l];
+                }
+            }
+
+            for( Int i = 0; i < edge_count_; ++i )
+            {
+                Real zz [Lanes] = {};
+
+                if constexpr ( AmbDim == 2 )
+                {
+                    cptr<Real> x_i0 = &x_(i,0,0);
+                    cptr<Real> x_i1 = &x_(i,1,0);
+                    mptr<Real> y_i0 = &y_(i,0,0);
+                    mptr<Real> y_i1 = &y_(i,1,0);
+
+                    for( Int l = 0; l < Lanes; ++l )
+                    {
+                        Sampler_T::MoebiusShift_Planar(
+                            x_i0[l], x_i1[l], w_[0][l], w_[1][l], w2_re[l], w2_im[l], one_plus_ww[l],
+                            y_i0[l], y_i1[l]
+                        );
+
+                        zz[l] = y_i0[l] * y_i0[l] + y_i1[l] * y_i1[l];
+                    }
+                }
+                else
+                {
+                    Real wx2 [Lanes] = {};
+
+                    for( Int j = 0; j < AmbDim; ++j )
+                    {
+                        cptr<Real> x_ij = &x_(i,j,0);
+
+                        for( Int l = 0; l < Lanes; ++l )
+                        {
+                            wx2[l] += w_[j][l] * x_ij[l];
+                        }
+                    }
+
+                    Real a [Lanes];
+                    Real b [Lanes];
+
+                    for( Int l = 0; l < Lanes; ++l )
+                    {
+                        wx2[l] *= two;
+
+                        const Real d = one / ( one_plus_ww[l] - wx2[l] );
+
+                        a[l] = one_minus_ww[l] * d;
+
+                        b[l] = (wx2[l] - two) * d;
+                    }
+
+                    for( Int j = 0; j < AmbDim; ++j )
+                    {
+                        cptr<Real> x_ij = &x_(i,j,0);
+                        mptr<Real> y_ij = &y_(i,j,0);
+
+                        for( Int l = 0; l < Lanes; ++l )
+                        {
+                            y_ij[l] = a[l] * x_ij[l] + b[l] * w_[j][l];
+
+                            zz[l] += y_ij[l] * y_ij[l];
+                        }
+                    }
+                }
+
+                // Branch-free normalization: lanes without normalization get the factor 1.
+                for( Int l = 0; l < Lanes; ++l )
+                {
+                    zz[l] = normalize[l] / std::sqrt(zz[l]) + (one - normalize[l]);
+                }
+
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    mptr<Real> y_ij = &y_(i,j,0);
+
+                    for( Int l = 0; l < Lanes; ++l )
+                    {
+                        y_ij[l] *= zz[l];
+                    }
+                }
+            }
+        }
+
+    public:
+
+        std::string ClassName() const
+        {
+            return std::string("CoBarS::BatchSampler") + "<" + ToString(AmbDim) + "," + TypeName<Real> + "," + TypeName<Int>  + "," + random_engine.ClassName() + "," + ToString(Lanes) + ">";
+        }
+
+    }; // class BatchSampler
+
+} // namespace CoBarS
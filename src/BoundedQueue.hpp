@@ -0,0 +1,113 @@
+#pragma once
+
+namespace CoBarS
+{
+
+    /*!
+     * @brief A bounded first-in-first-out queue for several producer and several consumer threads, implemented as a ring buffer.
+     *
+     * `Push` blocks while the queue is full and `Pop` blocks while it is empty. So a slow consumer throttles the producers (backpressure), and the memory used by the queue never exceeds its capacity.
+     *
+     * After `Close` has been called, `Pop` returns `false` as soon as the queue is empty, and `Push` returns `false` immediately.
+     */
+
+    template<typename T>
+    class BoundedQueue
+    {
+    private:
+
+        std::vector<T> ring;
+
+        Size_T head  = 0;
+        Size_T count = 0;
+
+        bool closedQ = false;
+
+        std::mutex mutex;
+
+        std::condition_variable not_full;
+        std::condition_variable not_empty;
+
+    public:
+
+        explicit BoundedQueue( const Size_T capacity )
+        :   ring ( std::max( Size_T(1), capacity ) )
+        {}
+
+        ~BoundedQueue() = default;
+
+        BoundedQueue( const BoundedQueue & other ) = delete;
+
+        BoundedQueue & operator=( const BoundedQueue & other ) = delete;
+
+
+        Size_T Capacity() const
+        {
+            return ring.size();
+        }
+
+        bool Push( T value )
+        {
+            std::unique_lock<std::mutex> lock ( mutex );
+
+            not_full.wait( lock, [this]{ return closedQ || (count < ring.size()); } );
+
+            if( closedQ )
+            {
+                return false;
+            }
+
+            ring[(head + count) % ring.size()] = std::move(value);
+
+            ++count;
+
+            lock.unlock();
+
+            not_empty.notify_one();
+
+            return true;
+        }
+
+        bool Pop( T & value )
+        {
+            std::unique_lock<std::mutex> lock ( mutex );
+
+            not_empty.wait( lock, [this]{ return closedQ || (count > 0); } );
+
+            if( count == 0 )
+            {
+                return false;
+            }
+
+            value = std::move( ring[head] );
+
+            head = (head + 1) % ring.size();
+
+            --count;
+
+            lock.unlock();
+
+            not_full.notify_one();
+
+            return true;
+        }
+
+        /*!
+         * @brief Wakes up all waiting threads. Elements that are already in the queue can still be popped.
+         */
+
+        void Close()
+        {
+            {
+                const std::lock_guard<std::mutex> lock ( mutex );
+
+                closedQ = true;
+            }
+
+            not_full.notify_all();
+            not_empty.notify_all();
+        }
+
+    }; // class BoundedQueue
+
+} // namespace CoBarS
@@ -0,0 +1,164 @@
+#pragma once
+
+// Compact storage formats for the output of the sampling routines; see Sampler::CreateRandomClosedPolygons_Float32, Sampler::CreateRandomClosedPolygons_Octahedral, etc.
+//
+// Octahedral encoding of unit vectors in R^3: A unit vector v is projected onto the octahedron |x| + |y| + |z| = 1; the lower half of the octahedron is folded over the upper half, and the result is flattened to the square [-1,1]^2. Both coordinates are quantized to 16 bits. The angular error is below 7e-5; see
+//
+//     Z. H. Cigolle, S. Donow, D. Evangelakos, M. Mara, M. McGuire, Q. Meyer:
+//     A survey of efficient representations for independent unit vectors.
+//     Journal of Computer Graphics Techniques 3 (2014).
+
+namespace CoBarS
+{
+
+/*!
+ * @brief Encodes the unit vector `(x,y,z)` into two 16-bit integers `a` and `b` by octahedral encoding. Branch-free, so that loops over it can be vectorized.
+ */
+
+    template<typename Real>
+    inline void OctahedralEncode(
+        const Real x, const Real y, const Real z, std::uint16_t & a, std::uint16_t & b
+    )
+    {
+        constexpr Real one   = 1;
+        constexpr Real half  = Real(1)/Real(2);
+        constexpr Real scale = Real(65535)/Real(2);
+
+        const Real inv_norm = one / ( std::abs(x) + std::abs(y) + std::abs(z) );
+
+        const Real u = x * inv_norm;
+        const Real v = y * inv_norm;
+
+        // Fold the lower half of the octahedron over the upper half.
+        const Real u_fold = std::copysign( one - std::abs(v), u );
+        const Real v_fold = std::copysign( one - std::abs(u), v );
+
+        const Real s = (z < Real(0)) ? u_fold : u;
+        const Real t = (z < Real(0)) ? v_fold : v;
+
+        a = static_cast<std::uint16_t>( std::floor( (s + one) * scale + half ) );
+        b = static_cast<std::uint16_t>( std::floor( (t + one) * scale + half ) );
+    }
+
+/*!
+ * @brief Decodes a unit vector `(x,y,z)` from its octahedral encoding `(a,b)`; see `OctahedralEncode`.
+ */
+
+    template<typename Real>
+    inline void OctahedralDecode(
+        const std::uint16_t a, const std::uint16_t b, Real & x, Real & y, Real & z
+    )
+    {
+        constexpr Real one   = 1;
+        constexpr Real scale = Real(2)/Real(65535);
+
+        Real u = static_cast<Real>(a) * scale - one;
+        Real v = static_cast<Real>(b) * scale - one;
+
+        const Real w = one - std::abs(u) - std::abs(v);
+
+        // Unfold the lower half of the octahedron.
+        const Real t = std::max( -w, Real(0) );
+
+        u -= std::copysign( t, u );
+        v -= std::copysign( t, v );
+
+        const Real inv_norm = one / std::sqrt( u * u + v * v + w * w );
+
+        x = u * inv_norm;
+        y = v * inv_norm;
+        z = w * inv_norm;
+    }
+
+/*!
+ * @brief Encodes the `count` unit vectors in `y` (of size `3 * count`, interleaved) into `code` (of size `2 * count`).
+ */
+
+    template<typename Real, typename Int>
+    void OctahedralEncodeVectors( cptr<Real> y, mptr<std::uint16_t> code, const Int count )
+    {
+        for( Int i = 0; i < count; ++i )
+        {
+            OctahedralEncode(
+                y[3 * i + 0], y[3 * i + 1], y[3 * i + 2], code[2 * i + 0], code[2 * i + 1]
+            );
+        }
+    }
+
+/*!
+ * @brief Decodes `count` unit vectors from `code` (of size `2 * count`) into `y` (of size `3 * count`, interleaved).
+ */
+
+    template<typename Real, typename Int>
+    void OctahedralDecodeVectors( cptr<std::uint16_t> code, mptr<Real> y, const Int count )
+    {
+        for( Int i = 0; i < count; ++i )
+        {
+            OctahedralDecode(
+                code[2 * i + 0], code[2 * i + 1], y[3 * i + 0], y[3 * i + 1], y[3 * i + 2]
+            );
+        }
+    }
+
+/*!
+ * @brief Reconstructs the vertex positions of `sample_count` closed polygons in R^3 from their octahedrally encoded unit edge vectors, as written by `Sampler::CreateRandomClosedPolygons_Octahedral`.
+ *
+ * The vertices are centered at the barycenter, as in `Sampler::WriteVertexPositions`. Because of the quantization, the last vertex differs from the first one by up to `1e-4` times the total edge length.
+ *
+ * @param code Source array of size `sample_count * edge_count * 2`.
+ *
+ * @param r The edge lengths; of size `edge_count`.
+ *
+ * @param q Target array of size `sample_count * (edge_count + 1) * 3`.
+ */
+
+    template<typename Real, typename Int>
+    void OctahedralDecodePolygons(
+        cptr<std::uint16_t> code, cptr<Real> r, const Int edge_count,
+        mptr<Real> q, const Int sample_count
+    )
+    {
+        constexpr Real half = Real(1)/Real(2);
+
+        for( Int k = 0; k < sample_count; ++k )
+        {
+            mptr<Real> q_k = &q[(edge_count + 1) * 3 * k];
+
+            // The unit edge vectors are decoded into the upper part of q_k and then summed up.
+            OctahedralDecodeVectors( &code[2 * edge_count * k], &q_k[3], edge_count );
+
+            Real barycenter [3] = {};
+            Real point      [3] = {};
+
+            for( Int i = 0; i < edge_count; ++i )
+            {
+                for( Int j = 0; j < 3; ++j )
+                {
+                    const Real delta = r[i] * q_k[3 * (i + 1) + j];
+
+                    q_k[3 * i + j] = point[j];
+
+                    barycenter[j] += point[j] + half * delta;
+
+                    point[j] += delta;
+                }
+            }
+
+            for( Int j = 0; j < 3; ++j )
+            {
+                q_k[3 * edge_count + j] = point[j];
+
+                barycenter[j] /= static_cast<Real>(edge_count);
+            }
+
+            for( Int i = 0; i <= edge_count; ++i )
+            {
+                for( Int j = 0; j < 3; ++j )
+                {
+                    q_k[3 * i + j] -= barycenter[j];
+                }
+            }
+        }
+    }
+
+} // namespace CoBarS
@@ -0,0 +1,744 @@
+#pragma once
+
+namespace CoBarS
+{
+
+    /*!
+     * @brief The state of the estimator of `CoBarS::Sampler::ConfidenceSample`: the number `N` of samples and the running sums of the weighted moments of the random variables.
+     *
+     * For the sampling weight `K` and each random variable `F_i`, the following sums over all samples are stored:
+     *  - `Moment(0,i)` = sum of `K * F_i`,
+     *  - `Moment(1,i)` = sum of `(K * F_i)^2`,
+     *  - `Moment(2,i)` = sum of `K * F_i * K`,
+     *  - `Moment(3,i)` = sum of `K * F_i * F_i`,
+     *  - `Moment(0,FunCount())` = sum of `K`,
+     *  - `Moment(1,FunCount())` = sum of `K^2`.
+     *
+     * Optionally, the state carries control variables `G_j` with known expectations `mu_j` (w.r.t. the same measure as the `F_i`). Then also the sums of `K * G_j`, `K^2 * G_j`, `K^2 * G_j * G_l`, and `K^2 * F_i * G_j` are stored (in this order, after the rows above), and the estimate of the expectation of `F_i` is the regression estimate of `F_i - sum_j beta_j (G_j - mu_j)`. The coefficients `beta_j` are chosen so as to minimize the asymptotic variance of the ratio estimator; they are estimated from the state. The confidence intervals are those of the controlled estimate. This pays off for random variables that are strongly correlated with cheap ones whose expectations are known.
+     *
+     * A random variable can be retired (see `Retire`) once its estimate is good enough: From then on, its moments are no longer accumulated, and its statistics are frozen; they refer to the first `SampleCount(i)` samples.
+     *
+     * All sums are compensated (Neumaier's variant of Kahan summation), so that also merging 10^11 samples from many shards is accurate to a few ulps. States of independent runs on disjoint random streams (other processes, other machines) can be merged with `Merge` and transferred with `Serialize` and `Deserialize`. The stopping rule and the confidence intervals are computed from the state alone; see `GearyConditionQ`, `CurrentConfidence`, and `Error`.
+     */
+
+    template<typename Real, typename Int>
+    class ConfidenceState
+    {
+        static_assert(FloatQ<Real>,"");
+        static_assert(IntQ<Int>,"");
+
+    public:
+
+        static constexpr Int RowCount = 4;
+
+    private:
+
+        static constexpr std::uint64_t Magic   = 0x5453464E4F434243; // "CBCONFST"
+        static constexpr std::uint64_t Version = 3;
+
+        std::uint64_t N = 0;
+
+        Int fun_count = 0;
+
+        Int control_count = 0;
+
+        std::vector<std::string> tags;
+
+        std::vector<std::string> control_tags;
+        std::vector<Real>        control_means;
+
+        std::vector<Real> sums;
+        std::vector<Real> comps;
+
+        // For each retired random variable: the sample count and the sums that are shared by all random variables (see Shared) at retirement; 0 for active ones.
+        std::vector<std::uint64_t> retired_N;
+        std::vector<Real>          retired_shared;
+
+    public:
+
+        ConfidenceState() = default;
+
+        explicit ConfidenceState(
+            const std::vector<std::string> & tags_,
+            const std::vector<std::string> & control_tags_  = {},
+            const std::vector<Real>        & control_means_ = {}
+        )
+        :   fun_count      ( static_cast<Int>(tags_.size()) )
+        ,   control_count  ( static_cast<Int>(std::min( control_tags_.size(), control_means_.size() )) )
+        ,   tags           ( tags_ )
+        ,   control_tags   ( control_tags_.begin(),  control_tags_.begin()  + control_count )
+        ,   control_means  ( control_means_.begin(), control_means_.begin() + control_count )
+        ,   sums           ( static_cast<Size_T>(MomentCount()), Real(0) )
+        ,   comps          ( static_cast<Size_T>(MomentCount()), Real(0) )
+        ,   retired_N      ( static_cast<Size_T>(fun_count), std::uint64_t(0) )
+        ,   retired_shared ( static_cast<Size_T>(fun_count * SharedCount()), Real(0) )
+        {}
+
+        ~ConfidenceState() = default;
+
+
+        Int FunCount() const
+        {
+            return fun_count;
+        }
+
+        Int ControlCount() const
+        {
+            return control_count;
+        }
+
+        /*!
+         * @brief The number of sums; the layout is described above.
+         */
+
+        Int MomentCount() const
+        {
+            return RowCount * (fun_count + 1) + control_count * (2 + control_count + fun_count);
+        }
+
+        std::uint64_t SampleCount() const
+        {
+            return N;
+        }
+
+        /*!
+         * @brief The number of samples that the `i`-th random variable was evaluated on.
+         */
+
+        std::uint64_t SampleCount( const Int i ) const
+        {
+            return ActiveQ(i) ? N : retired_N[static_cast<Size_T>(i)];
+        }
+
+        bool ActiveQ( const Int i ) const
+        {
+            return retired_N[static_cast<Size_T>(i)] == 0;
+        }
+
+        /*!
+         * @brief Freezes the statistics of the `i`-th random variable at the current sample count. The caller must not add further moments for it.
+         */
+
+        void Retire( const Int i )
+        {
+            if( ActiveQ(i) && (N > 0) )
+            {
+                for( Int k = 0; k < SharedCount(); ++k )
+                {
+                    retired_shared[static_cast<Size_T>(SharedCount() * i + k)] = Shared(fun_count,k);
+                }
+
+                retired_N[static_cast<Size_T>(i)] = N;
+            }
+        }
+
+        bool AnyRetiredQ() const
+        {
+            return std::any_of( retired_N.begin(), retired_N.end(), []( const std::uint64_t n ){ return n != 0; } );
+        }
+
+        const std::vector<std::string> & Tags() const
+        {
+            return tags;
+        }
+
+        const std::vector<std::string> & ControlTags() const
+        {
+            return control_tags;
+        }
+
+        const std::vector<Real> & ControlMeans() const
+        {
+            return control_means;
+        }
+
+        /*!
+         * @brief Whether `other` belongs to the same random variables and control variables.
+         */
+
+        bool SameVariablesQ( const ConfidenceState & other ) const
+        {
+            return (tags == other.tags) && (control_tags == other.control_tags) && (control_means == other.control_means);
+        }
+
+        Real Moment( const Int row, const Int i ) const
+        {
+            const Size_T pos = static_cast<Size_T>( (fun_count + 1) * row + i );
+
+            return sums[pos] + comps[pos];
+        }
+
+        void SetZero()
+        {
+            N = 0;
+
+            std::fill( sums.begin(),  sums.end(),  Real(0) );
+            std::fill( comps.begin(), comps.end(), Real(0) );
+
+            std::fill( retired_N.begin(), retired_N.end(), std::uint64_t(0) );
+            std::fill( retired_shared.begin(), retired_shared.end(), Real(0) );
+        }
+
+        /*!
+         * @brief Adds the moments of `n` further samples; `moments` has size `MomentCount()` and the layout described above. The entries of retired random variables must be 0.
+         */
+
+        void AddMoments( cptr<Real> moments, const std::uint64_t n )
+        {
+            for( Size_T pos = 0; pos < sums.size(); ++pos )
+            {
+                CompensatedAdd( sums[pos], comps[pos], moments[pos] );
+            }
+
+            N += n;
+        }
+
+        /*!
+         * @brief Adds the samples of `other`. Returns `false` (and does nothing) if `other` belongs to different random variables or control variables or if one of the states has retired random variables.
+         */
+
+        bool Merge( const ConfidenceState & other )
+        {
+            if( !SameVariablesQ( other ) )
+            {
+                eprint( ClassName() + "::Merge: The states belong to different random variables." );
+
+                return false;
+            }
+
+            if( AnyRetiredQ() || other.AnyRetiredQ() )
+            {
+                eprint( ClassName() + "::Merge: States with retired random variables cannot be merged." );
+
+                return false;
+            }
+
+            for( Size_T pos = 0; pos < sums.size(); ++pos )
+            {
+                CompensatedAdd( sums[pos], comps[pos], other.sums [pos] );
+                CompensatedAdd( sums[pos], comps[pos], other.comps[pos] );
+            }
+
+            N += other.N;
+
+            return true;
+        }
+
+        /*!
+         * @brief Returns a binary representation (native byte order) of the state.
+         */
+
+        std::string Serialize() const
+        {
+            std::string s;
+
+            Append( s, Magic );
+            Append( s, Version );
+            Append( s, static_cast<std::uint64_t>(sizeof(Real)) );
+            Append( s, N );
+            Append( s, static_cast<std::uint64_t>(fun_count) );
+            Append( s, static_cast<std::uint64_t>(control_count) );
+
+            for( const std::string & tag : tags )
+            {
+                AppendString( s, tag );
+            }
+
+            for( Int j = 0; j < control_count; ++j )
+            {
+                AppendString( s, control_tags[static_cast<Size_T>(j)] );
+                Append( s, control_means[static_cast<Size_T>(j)] );
+            }
+
+            for( Size_T pos = 0; pos < sums.size(); ++pos )
+            {
+                Append( s, sums [pos] );
+                Append( s, comps[pos] );
+            }
+
+            for( const std::uint64_t n : retired_N )
+            {
+                Append( s, n );
+            }
+
+            for( const Real x : retired_shared )
+            {
+                Append( s, x );
+            }
+
+            return s;
+        }
+
+        /*!
+         * @brief Reads a state that was created by `Serialize`. Returns `false` if `s` is not a valid state; then the state is left unchanged.
+         */
+
+        bool Deserialize( const std::string & s )
+        {
+            Size_T pos = 0;
+
+            std::uint64_t magic        = 0;
+            std::uint64_t version      = 0;
+            std::uint64_t real_size    = 0;
+            std::uint64_t N_           = 0;
+            std::uint64_t fun_count_   = 0;
+            std::uint64_t control_count_ = 0;
+
+            bool okQ = Read( s, pos, magic ) && (magic == Magic)
+                && Read( s, pos, version )   && (version == Version)
+                && Read( s, pos, real_size ) && (real_size == sizeof(Real))
+                && Read( s, pos, N_ )
+                && Read( s, pos, fun_count_ )
+                && Read( s, pos, control_count_ );
+
+            std::vector<std::string> tags_;
+            std::vector<std::string> control_tags_;
+            std::vector<Real>        control_means_;
+
+            for( std::uint64_t i = 0; okQ && (i < fun_count_); ++i )
+            {
+                tags_.emplace_back();
+
+                okQ = ReadString( s, pos, tags_.back() );
+            }
+
+            for( std::uint64_t j = 0; okQ && (j < control_count_); ++j )
+            {
+                control_tags_.emplace_back();
+                control_means_.emplace_back();
+
+                okQ = ReadString( s, pos, control_tags_.back() ) && Read( s, pos, control_means_.back() );
+            }
+
+            ConfidenceState other ( tags_, control_tags_, control_means_ );
+
+            for( Size_T i = 0; okQ && (i < other.sums.size()); ++i )
+            {
+                okQ = Read( s, pos, other.sums[i] ) && Read( s, pos, other.comps[i] );
+            }
+
+            for( Size_T i = 0; okQ && (i < other.retired_N.size()); ++i )
+            {
+                okQ = Read( s, pos, other.retired_N[i] );
+            }
+
+            for( Size_T i = 0; okQ && (i < other.retired_shared.size()); ++i )
+            {
+                okQ = Read( s, pos, other.retired_shared[i] );
+            }
+
+            if( !okQ || (pos != s.size()) )
+            {
+                eprint( ClassName() + "::Deserialize: Invalid input." );
+
+                return false;
+            }
+
+            other.N = N_;
+
+            *this = std::move(other);
+
+            return true;
+        }
+
+
+        // Statistics; these are only meaningful for N > 1.
+
+        /*!
+         * @brief Geary's condition: The mean of the sampling weight is at least 3 of its standard errors away from 0. Only then the confidence intervals are reliable.
+         */
+
+        bool GearyConditionQ() const
+        {
+            return MeanY(fun_count) / std::sqrt( VarY(fun_count) ) >= static_cast<Real>(3);
+        }
+
+        /*!
+         * @brief The estimate of the expectation of the `i`-th random variable.
+         */
+
+        Real Mean( const Int i ) const
+        {
+            return MeanX(i) / MeanY(i);
+        }
+
+        /*!
+         * @brief The current regression coefficients `beta_j` of the control variables for the `i`-th random variable.
+         */
+
+        std::vector<Real> ControlCoefficients( const Int i ) const
+        {
+            return Controlled(i).beta;
+        }
+
+        /*!
+         * @brief The estimate of the variance of the `i`-th random variable.
+         */
+
+        Real SampleVariance( const Int i ) const
+        {
+            const Real T = Mean(i);
+
+            return BesselCorrection(i) * ( Moment(3,i) / KMoment(0,i) - T * T );
+        }
+
+        /*!
+         * @brief The confidence level of the interval of radius `radius` around `Mean(i)`. If `relativeQ` is set, `radius` is relative to `Mean(i)`.
+         */
+
+        Real CurrentConfidence( const Int i, const Real radius, const bool relativeQ ) const
+        {
+            const Real T = Mean(i);
+
+            const Real absolute_radius = relativeQ ? radius * T : radius;
+
+            const GearyTransform<Real> G = Geary(i);
+
+            // t - G( T ) is a standard Gaussian.
+            // See Geary - The Frequency Distribution of the Quotient of Two Normal Variates (1930)
+            // https://www.jstor.org/stable/2342070
+
+            return N_CDF( G( T + absolute_radius ) ) - N_CDF( G( T - absolute_radius ) );
+        }
+
+        /*!
+         * @brief The radius of the confidence interval of level `confidence` around `Mean(i)`; `radius` is used as starting guess.
+         */
+
+        Real Error( const Int i, const Real radius, const Real confidence, const bool relativeQ ) const
+        {
+            const Real T = Mean(i);
+
+            const GearyTransform<Real> G = Geary(i);
+
+            auto P = [T,&G]( const Real b )
+            {
+                return N_CDF( G( T + b ) ) - N_CDF( G( T - b ) );
+            };
+
+            Real a = 0;
+            Real b = relativeQ ? radius * T : radius;
+
+            // Extend the search interval to make sure that the actual confidence radius lies within [a,b)
+            while( P(b) <= confidence )
+            {
+                a = b;
+
+                b *= static_cast<Real>(2);
+            }
+
+            return BisectionSearch<1>( std::move(P), a, b, confidence, Real(0.0001) );
+        }
+
+        std::string ClassName() const
+        {
+            return std::string("CoBarS::ConfidenceState") + "<" + TypeName<Real> + "," + TypeName<Int> + ">";
+        }
+
+    private:
+
+        static void CompensatedAdd( Real & sum, Real & comp, const Real x )
+        {
+            const Real t = sum + x;
+
+            comp += ( std::abs(sum) >= std::abs(x) ) ? ( (sum - t) + x ) : ( (x - t) + sum );
+
+            sum = t;
+        }
+
+        // Sums of all samples that do not depend on the random variable: K, K^2, K * G_j, K^2 * G_j, K^2 * G_j * G_l. For retired random variables, the values at retirement are used; i = fun_count refers to the current values.
+
+        Int SharedCount() const
+        {
+            return 2 + control_count * (2 + control_count);
+        }
+
+        Real Sum( const Int pos ) const
+        {
+            return sums[static_cast<Size_T>(pos)] + comps[static_cast<Size_T>(pos)];
+        }
+
+        Real Shared( const Int i, const Int k ) const
+        {
+            if( (i < fun_count) && !ActiveQ(i) )
+            {
+                return retired_shared[static_cast<Size_T>(SharedCount() * i + k)];
+            }
+
+            return (k < 2) ? Moment(k,fun_count) : Sum( RowCount * (fun_count + 1) + k - 2 );
+        }
+
+        // The sums of K * F_i, (K * F_i)^2, and K * F_i * K -- with F_i replaced by the controlled variable F_i - sum_j beta_j (G_j - mu_j) if there are control variables.
+
+        struct ControlledMoments
+        {
+            Real KF    = 0;
+            Real KF_KF = 0;
+            Real KF_K  = 0;
+
+            std::vector<Real> beta;
+        };
+
+        ControlledMoments Controlled( const Int i ) const
+        {
+            ControlledMoments result;
+
+            result.KF    = Moment(0,i);
+            result.KF_KF = Moment(1,i);
+            result.KF_K  = Moment(2,i);
+
+            const Int c = control_count;
+
+            result.beta.assign( static_cast<Size_T>(c), Real(0) );
+
+            if( (c == 0) || (Count(i) < 2) )
+            {
+                return result;
+            }
+
+            const Real n    = static_cast<Real>( Count(i) );
+            const Real S_K  = Shared(i,0);
+            const Real S_KK = Shared(i,1);
+
+            auto S_KG    = [&]( const Int j )              { return Shared( i, 2 + j ); };
+            auto S_KKG   = [&]( const Int j )              { return Shared( i, 2 + c + j ); };
+            auto S_KKGG  = [&]( const Int j, const Int l ) { return Shared( i, 2 + 2 * c + c * j + l ); };
+            auto S_KKFG  = [&]( const Int j )              { return Sum( RowCount * (fun_count + 1) + c * (2 + c + i) + j ); };
+            auto mu      = [&]( const Int j )              { return control_means[static_cast<Size_T>(j)]; };
+
+            // With W_j = K * (G_j - mu_j), the controlled ratio estimator has the influence function K * F - theta * K - sum_j beta_j W_j. We minimize its variance.
+
+            const Real theta = result.KF / S_K;
+
+            std::vector<Real> S_W  ( static_cast<Size_T>(c) );
+            std::vector<Real> S_WK ( static_cast<Size_T>(c) );
+            std::vector<Real> S_FW ( static_cast<Size_T>(c) );
+            std::vector<Real> S_WW ( static_cast<Size_T>(c * c) );
+            std::vector<Real> C_WW ( static_cast<Size_T>(c * c) );
+            std::vector<Real> C_WU ( static_cast<Size_T>(c) );
+
+            for( Int j = 0; j < c; ++j )
+            {
+                const Size_T j_ = static_cast<Size_T>(j);
+
+                S_W [j_] = S_KG (j) - mu(j) * S_K;
+                S_WK[j_] = S_KKG(j) - mu(j) * S_KK;
+                S_FW[j_] = S_KKFG(j) - mu(j) * result.KF_K;
+
+                C_WU[j_] = ( S_FW[j_] - theta * S_WK[j_] ) / n;
+            }
+
+            for( Int j = 0; j < c; ++j )
+            {
+                for( Int l = 0; l < c; ++l )
+                {
+                    const Size_T jl = static_cast<Size_T>(c * j + l);
+
+                    S_WW[jl] = S_KKGG(j,l) - mu(l) * S_KKG(j) - mu(j) * S_KKG(l) + mu(j) * mu(l) * S_KK;
+
+                    C_WW[jl] = S_WW[jl] / n - (S_W[static_cast<Size_T>(j)] / n) * (S_W[static_cast<Size_T>(l)] / n);
+                }
+            }
+
+            result.beta = C_WU;
+
+            SolveSymmetric( C_WW, result.beta, c );
+
+            for( Int j = 0; j < c; ++j )
+            {
+                const Size_T j_ = static_cast<Size_T>(j);
+
+                const Real b = result.beta[j_];
+
+                result.KF    -= b * S_W [j_];
+                result.KF_KF -= Real(2) * b * S_FW[j_];
+                result.KF_K  -= b * S_WK[j_];
+
+                for( Int l = 0; l < c; ++l )
+                {
+                    result.KF_KF += b * result.beta[static_cast<Size_T>(l)] * S_WW[static_cast<Size_T>(c * j + l)];
+                }
+            }
+
+            return result;
+        }
+
+        // Solves A x = b in place (b is overwritten by x) for the symmetric positive semidefinite c x c matrix A by Gaussian elimination with partial pivoting. Directions in which A is (numerically) singular get the coefficient 0.
+
+        static void SolveSymmetric( std::vector<Real> A, std::vector<Real> & b, const Int c )
+        {
+            auto a = [&]( const Int j, const Int l ) -> Real & { return A[static_cast<Size_T>(c * j + l)]; };
+
+            Real scale = 0;
+
+            for( Int j = 0; j < c; ++j )
+            {
+                scale = std::max( scale, std::abs( a(j,j) ) );
+            }
+
+            const Real threshold = scale * static_cast<Real>(c) * std::numeric_limits<Real>::epsilon() * Real(16);
+
+            std::vector<bool> singularQ ( static_cast<Size_T>(c), false );
+
+            for( Int k = 0; k < c; ++k )
+            {
+                Int p = k;
+
+                for( Int j = k + 1; j < c; ++j )
+                {
+                    if( std::abs( a(j,k) ) > std::abs( a(p,k) ) )
+                    {
+                        p = j;
+                    }
+                }
+
+                if( std::abs( a(p,k) ) <= threshold )
+                {
+                    singularQ[static_cast<Size_T>(k)] = true;
+
+                    continue;
+                }
+
+                if( p != k )
+                {
+                    for( Int l = 0; l < c; ++l )
+                    {
+                        std::swap( a(k,l), a(p,l) );
+                    }
+
+                    std::swap( b[static_cast<Size_T>(k)], b[static_cast<Size_T>(p)] );
+                }
+
+                for( Int j = k + 1; j < c; ++j )
+                {
+                    const Real factor = a(j,k) / a(k,k);
+
+                    for( Int l = k; l < c; ++l )
+                    {
+                        a(j,l) -= factor * a(k,l);
+                    }
+
+                    b[static_cast<Size_T>(j)] -= factor * b[static_cast<Size_T>(k)];
+                }
+            }
+
+            for( Int k = c; k-- > 0; )
+            {
+                if( singularQ[static_cast<Size_T>(k)] )
+                {
+                    b[static_cast<Size_T>(k)] = 0;
+
+                    continue;
+                }
+
+                Real x = b[static_cast<Size_T>(k)];
+
+                for( Int l = k + 1; l < c; ++l )
+                {
+                    x -= a(k,l) * b[static_cast<Size_T>(l)];
+                }
+
+                b[static_cast<Size_T>(k)] = x / a(k,k);
+            }
+        }
+
+        // The statistics of random variable i; i = fun_count refers to the active ones.
+
+        std::uint64_t Count( const Int i ) const
+        {
+            return (i < fun_count) ? SampleCount(i) : N;
+        }
+
+        // The sums of K (row = 0) and K^2 (row = 1) over the samples of random variable i.
+        Real KMoment( const Int row, const Int i ) const
+        {
+            return Shared(i,row);
+        }
+
+        Real BesselCorrection( const Int i ) const
+        {
+            return Frac<Real>( Count(i), Count(i) - 1 );
+        }
+
+        Real MeanY( const Int i ) const
+        {
+            return Frac<Real>( KMoment(0,i), Count(i) );
+        }
+
+        Real VarY( const Int i ) const
+        {
+            const Real mean_K = MeanY(i);
+
+            const Real var_K = BesselCorrection(i) * ( Frac<Real>( KMoment(1,i), Count(i) ) - mean_K * mean_K );
+
+            return Frac<Real>( var_K, Count(i) );
+        }
+
+        Real MeanX( const Int i ) const
+        {
+            return Frac<Real>( Controlled(i).KF, Count(i) );
+        }
+
+        GearyTransform<Real> Geary( const Int i ) const
+        {
+            const ControlledMoments m = Controlled(i);
+
+            const Real mean_K   = MeanY(i);
+            const Real mean_KF  = Frac<Real>( m.KF, Count(i) );
+
+            const Real var_KF   = BesselCorrection(i) * ( Frac<Real>( m.KF_KF, Count(i) ) - mean_KF * mean_KF );
+
+            const Real cov_KF_K = BesselCorrection(i) * ( Frac<Real>( m.KF_K, Count(i) ) - mean_KF * mean_K  );
+
+            return GearyTransform<Real>(
+                mean_KF, mean_K, Frac<Real>( var_KF, Count(i) ), Frac<Real>( cov_KF_K, Count(i) ), VarY(i)
+            );
+        }
+
+        template<typename T>
+        static void Append( std::string & s, const T & x )
+        {
+            s.append( reinterpret_cast<const char *>(&x), sizeof(T) );
+        }
+
+        static void AppendString( std::string & s, const std::string & x )
+        {
+            Append( s, static_cast<std::uint64_t>(x.size()) );
+
+            s.append( x );
+        }
+
+        static bool ReadString( const std::string & s, Size_T & pos, std::string & x )
+        {
+            std::uint64_t length = 0;
+
+            if( !Read( s, pos, length ) || (pos + length > s.size()) )
+            {
+                return false;
+            }
+
+            x = s.substr( pos, static_cast<Size_T>(length) );
+
+            pos += static_cast<Size_T>(length);
+
+            return true;
+        }
+
+        template<typename T>
+        static bool Read( const std::string & s, Size_T & pos, T & x )
+        {
+            if( pos + sizeof(T) > s.size() )
+            {
+                return false;
+            }
+
+            std::memcpy( &x, s.data() + pos, sizeof(T) );
+
+            pos += sizeof(T);
+
+            return true;
+        }
+
+    }; // class ConfidenceState
+
+} // namespace CoBarS
@@ -76,6 +76,9 @@ namespace CoBarS
                 
                 z.Write( S2D.x_, k );
             }
+            
+            S2D.ComputeEdgeConstants();
+            S  .ComputeEdgeConstants();
         }
         
         
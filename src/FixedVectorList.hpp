@@ -0,0 +1,108 @@
+#pragma once
+
+namespace CoBarS
+{
+    /*!
+     * @class FixedVectorList
+     *
+     * @brief A list of `N` vectors in dimension `D`, stored in a plain array, so that its size is known at compile time and it lives wherever its owner lives (e.g., on the stack).
+     *
+     * This is the storage of the edge vectors and vertex positions of a `CoBarS::Sampler` with fixed edge count. It offers the part of the interfaces of `Tiny::VectorList` (if `SOA_Q`) and of `Tensor2` (otherwise) that the sampler uses: `list[j][i]` (`SOA_Q`) or `list[i][j]` (otherwise) is coordinate `j` of vector `i`, and `Read` and `Write` copy from and to an array with one vector after the other.
+     *
+     * @tparam D The dimension of the vectors.
+     *
+     * @tparam N The number of vectors.
+     *
+     * @tparam SOA_Q Whether to store the coordinates of all vectors one coordinate after another ("structure of arrays") or one vector after another.
+     */
+
+    template<int D, int N, typename Real, typename Int, bool SOA_Q>
+    class FixedVectorList
+    {
+        static_assert( D > 0, "" );
+        static_assert( N > 0, "" );
+
+    private:
+
+        static constexpr int rows    = SOA_Q ? D : N;
+        static constexpr int columns = SOA_Q ? N : D;
+
+        Real a [rows][columns];
+
+    public:
+
+        FixedVectorList() = default;
+
+        ~FixedVectorList() = default;
+
+        Real * operator[]( const Int k )
+        {
+            return &a[k][0];
+        }
+
+        const Real * operator[]( const Int k ) const
+        {
+            return &a[k][0];
+        }
+
+        Real * data()
+        {
+            return &a[0][0];
+        }
+
+        const Real * data() const
+        {
+            return &a[0][0];
+        }
+
+        static constexpr Int Dimension( const Int k )
+        {
+            return (k == 0) ? Int(rows) : Int(columns);
+        }
+
+        /*!
+         * @brief Reads `N` vectors from `p`, stored one after another.
+         */
+
+        void Read( cptr<Real> p )
+        {
+            for( Int i = 0; i < Int(N); ++i )
+            {
+                for( Int j = 0; j < Int(D); ++j )
+                {
+                    if constexpr ( SOA_Q )
+                    {
+                        a[j][i] = p[D * i + j];
+                    }
+                    else
+                    {
+                        a[i][j] = p[D * i + j];
+                    }
+                }
+            }
+        }
+
+        /*!
+         * @brief Writes the `N` vectors to `p`, one after another.
+         */
+
+        void Write( mptr<Real> p ) const
+        {
+            for( Int i = 0; i < Int(N); ++i )
+            {
+                for( Int j = 0; j < Int(D); ++j )
+                {
+                    if constexpr ( SOA_Q )
+                    {
+                        p[D * i + j] = a[j][i];
+                    }
+                    else
+                    {
+                        p[D * i + j] = a[i][j];
+                    }
+                }
+            }
+        }
+    };
+
+} // namespace CoBarS
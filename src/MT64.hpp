@@ -18,6 +18,9 @@ namespace CoBarS
         
         std::mt19937_64 random_engine;
         
+        std::uint64_t seed_   = 0;
+        std::uint64_t stream_ = 0;
+        
     public:
         
         using result_type = std::mt19937_64::result_type;
@@ -40,6 +43,28 @@ namespace CoBarS
             
         }
         
+        /*!
+         * @brief Deterministic seeding: `std::mt19937_64` has no cheap jump-ahead. So we seed the state of stream `stream` by `std::seed_seq` from the pair (`seed`,`stream`) instead.
+         */
+        
+        MT64( const std::uint64_t seed, const std::uint64_t stream ) noexcept
+        :   seed_   ( seed   )
+        ,   stream_ ( stream )
+        {
+            SeedStream();
+        }
+        
+        /*!
+         * @brief Jumps from the beginning of the current stream to the beginning of the next one.
+         */
+        
+        void NextStream() noexcept
+        {
+            ++stream_;
+            
+            SeedStream();
+        }
+        
         result_type operator()() noexcept
         {
             return random_engine();
@@ -59,6 +84,20 @@ namespace CoBarS
         {
             return std::string("MT64");
         }
+        
+    private:
+        
+        void SeedStream()
+        {
+            std::seed_seq seed {
+                static_cast<std::uint32_t>(seed_         ),
+                static_cast<std::uint32_t>(seed_   >> 32 ),
+                static_cast<std::uint32_t>(stream_       ),
+                static_cast<std::uint32_t>(stream_ >> 32 )
+            };
+            
+            random_engine.seed( seed );
+        }
     };
     
 } // namespace CoBarS
@@ -0,0 +1,98 @@
+#pragma once
+
+namespace CoBarS
+{
+    /*!
+     * @brief A list of edge counts for which `CoBarS::MakeSampler` instantiates a `CoBarS::Sampler` with compile-time edge count.
+     *
+     * Each entry adds one instantiation of the whole sampler, so keep the list short.
+     */
+
+    template<int... EDGE_COUNTS>
+    struct FixedEdgeCounts {};
+
+    /*!
+     * @brief The edge counts for which `CoBarS::MakeSampler` uses a `CoBarS::Sampler` with compile-time edge count by default.
+     */
+
+    using DefaultFixedEdgeCounts = FixedEdgeCounts<4,5,6,7,8,10,12,16,24,32>;
+
+
+    // Dispatches over the entries of the FixedEdgeCounts tag.
+
+    template<
+        int AMB_DIM, typename REAL, typename INT, typename PRNG_T, int... EDGE_COUNTS
+    >
+    std::unique_ptr<SamplerBase<AMB_DIM,REAL,INT>> MakeSampler(
+        FixedEdgeCounts<EDGE_COUNTS...>,
+        const REAL * restrict const r,
+        const REAL * restrict const rho,
+        const INT edge_count,
+        const SamplerSettings<REAL,INT> & settings
+    )
+    {
+        std::unique_ptr<SamplerBase<AMB_DIM,REAL,INT>> S;
+
+        // Try the fixed edge counts in turn; the fold stops at the first match.
+        (void)(
+            (
+                (edge_count == static_cast<INT>(EDGE_COUNTS))
+                &&
+                (
+                    S = std::make_unique<Sampler<AMB_DIM,REAL,INT,PRNG_T,true,false,EDGE_COUNTS>>(
+                        r, rho, edge_count, settings
+                    ),
+                    true
+                )
+            )
+            || ...
+        );
+
+        if( !S )
+        {
+            S = std::make_unique<Sampler<AMB_DIM,REAL,INT,PRNG_T,true,false>>(
+                r, rho, edge_count, settings
+            );
+        }
+
+        return S;
+    }
+
+    /*!
+     * @brief Creates a `CoBarS::Sampler` for polygons with edge lengths `r` and Riemannian metric `rho`, choosing the implementation at runtime.
+     *
+     * If `edge_count` is one of the `EDGE_COUNTS`, this returns an instance of `CoBarS::Sampler` with `EDGE_COUNT = edge_count`. Its polygons are stored in fixed-size arrays inside the object and all loops over the edges have compile-time trip counts; for small polygons, this is noticeably faster. Otherwise, this returns an instance with `EDGE_COUNT = 0`, which works for all edge counts.
+     *
+     * Both kinds of samplers produce the same polygons for the same seed.
+     *
+     * @param r The edge lengths; an array of size `edge_count`.
+     *
+     * @param rho The Riemannian metric; an array of size `edge_count`.
+     *
+     * @param edge_count The number of edges.
+     *
+     * @param settings The settings of the sampler.
+     *
+     * @tparam EDGE_COUNTS The edge counts for which a specialized sampler is compiled, given as `CoBarS::FixedEdgeCounts`.
+     */
+
+    template<
+        int AMB_DIM,
+        typename REAL   = double,
+        typename INT    = std::size_t,
+        typename PRNG_T = Xoshiro256Plus,
+        typename EDGE_COUNTS = DefaultFixedEdgeCounts
+    >
+    std::unique_ptr<SamplerBase<AMB_DIM,REAL,INT>> MakeSampler(
+        const REAL * restrict const r,
+        const REAL * restrict const rho,
+        const INT edge_count,
+        const SamplerSettings<REAL,INT> & settings = SamplerSettings<REAL,INT>()
+    )
+    {
+        return MakeSampler<AMB_DIM,REAL,INT,PRNG_T>(
+            EDGE_COUNTS(), r, rho, edge_count, settings
+        );
+    }
+
+} // namespace CoBarS
@@ -26,6 +26,34 @@ namespace CoBarS
         :   random_engine( pcg_extras::seed_seq_from<std::random_device>() )
         {}
         
+        /*!
+         * @brief Deterministic seeding: Seeds the state from `seed` and then advances it by `stream` * 2^64 steps; so this costs only O(1). Different streams do not overlap for the first 2^64 draws.
+         */
+        
+        PCG64( const std::uint64_t seed, const std::uint64_t stream ) noexcept
+        :   random_engine( static_cast<pcg64::state_type>(seed) )
+        {
+            random_engine.advance( PCG_128BIT_CONSTANT(stream,0) );
+        }
+        
+        /*!
+         * @brief Jumps from the beginning of the current stream to the beginning of the next one. Call this only on an instance that has not been used since it was constructed or since the last call to `NextStream`.
+         */
+        
+        void NextStream() noexcept
+        {
+            random_engine.advance( PCG_128BIT_CONSTANT(1,0) );
+        }
+        
+        /*!
+         * @brief Skips the next `count` draws in O(log(count)).
+         */
+        
+        void discard( const std::uint64_t count ) noexcept
+        {
+            random_engine.discard( static_cast<pcg64::state_type>(count) );
+        }
+        
         result_type operator()() noexcept
         {
             return random_engine();
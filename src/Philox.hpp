@@ -0,0 +1,254 @@
+#pragma once
+#include <cstdint>
+#include <array>
+
+
+// A counter-based pseudorandom number generator; see
+//
+//     J. K. Salmon, M. A. Moraes, R. O. Dror, D. E. Shaw:
+//     Parallel random numbers: as easy as 1, 2, 3.
+//     Proceedings of SC '11 (2011).
+//
+// In contrast to the other generators in CoBarS, the state is just a key (the seed) and a counter. Hence the output at any position can be computed directly, without running through the stream. We use the counter to address the random numbers of sample k directly.
+
+namespace CoBarS
+{
+    /*!
+     * @brief An implementation of _Philox4x32-10_ by Salmon, Moraes, Dror, and Shaw.
+     *
+     * The 128-bit counter consists of a 64-bit position and a 64-bit sample index; the 64-bit key is the seed. So the random stream of each sample is determined by the pair (seed, sample index), and `SetSampleIndex(k)` jumps directly to the beginning of the stream of sample `k`.
+     *
+     * Each counter gives 128 random bits, i.e., two 64-bit words. `operator()( a, count )` evaluates `BlockSize` counters at once by loops that the compiler can vectorize.
+     */
+
+    class Philox4x32
+    {
+    public:
+
+        using result_type = std::uint64_t;
+
+        static constexpr Size_T BlockSize = 8;
+
+    private:
+
+        static constexpr std::uint32_t M_0 = 0xD2511F53;
+        static constexpr std::uint32_t M_1 = 0xCD9E8D57;
+        static constexpr std::uint32_t W_0 = 0x9E3779B9;
+        static constexpr std::uint32_t W_1 = 0xBB67AE85;
+
+        static constexpr int RoundCount = 10;
+
+        static constexpr Size_T WordsPerCounter = 2;
+        static constexpr Size_T CountersPerBlock = BlockSize / WordsPerCounter;
+
+        std::uint64_t seed_         = 0;
+        std::uint64_t sample_index_ = 0;
+        std::uint64_t position_     = 0;
+
+        std::array<result_type,BlockSize> buffer_;
+
+        Size_T buffer_pos_ = BlockSize;
+
+    public:
+
+        Philox4x32() noexcept
+        {
+            std::random_device r;
+
+            seed_ = (static_cast<std::uint64_t>(r()) << 32) | static_cast<std::uint64_t>(r());
+        }
+
+        explicit Philox4x32(
+            const std::uint64_t seed, const std::uint64_t sample_index = 0
+        ) noexcept
+        :   seed_         ( seed         )
+        ,   sample_index_ ( sample_index )
+        {}
+
+        ~Philox4x32() = default;
+
+
+        std::uint64_t Seed() const noexcept
+        {
+            return seed_;
+        }
+
+        /*!
+         * @brief Sets the key and jumps to the beginning of the stream of the current sample index.
+         */
+
+        void Seed( const std::uint64_t seed ) noexcept
+        {
+            seed_ = seed;
+
+            SetSampleIndex( sample_index_ );
+        }
+
+        std::uint64_t SampleIndex() const noexcept
+        {
+            return sample_index_;
+        }
+
+        /*!
+         * @brief Jumps to the beginning of the stream of sample `k`. This costs nothing.
+         */
+
+        void SetSampleIndex( const std::uint64_t k ) noexcept
+        {
+            sample_index_ = k;
+            position_     = 0;
+            buffer_pos_   = BlockSize;
+        }
+        
+        /*!
+         * @brief Jumps to the beginning of the stream of the next sample index. This is the same interface as for the other generators in CoBarS; here the sample index plays the role of the stream.
+         */
+        
+        void NextStream() noexcept
+        {
+            SetSampleIndex( sample_index_ + 1 );
+        }
+
+        /*!
+         * @brief Skips the next `count` words in O(1).
+         */
+        
+        void discard( std::uint64_t count ) noexcept
+        {
+            const std::uint64_t buffered = BlockSize - buffer_pos_;
+            
+            if( count <= buffered )
+            {
+                buffer_pos_ += static_cast<Size_T>(count);
+                
+                return;
+            }
+            
+            count -= buffered;
+            
+            position_ += count / WordsPerCounter;
+            
+            buffer_pos_ = BlockSize;
+            
+            if( count % WordsPerCounter != 0 )
+            {
+                // Evaluate the counter that we are in the middle of and drop its first word.
+                Block( &buffer_[0] );
+                
+                buffer_pos_ = static_cast<Size_T>(count % WordsPerCounter);
+            }
+        }
+
+        result_type operator()() noexcept
+        {
+            if( buffer_pos_ >= BlockSize )
+            {
+                Block( &buffer_[0] );
+
+                buffer_pos_ = 0;
+            }
+
+            return buffer_[buffer_pos_++];
+        }
+
+        /*!
+         * @brief Writes the next `count` random words to `a`. This is equivalent to `count` calls to `operator()()`, but much faster for large `count`.
+         */
+
+        void operator()( mptr<result_type> a, const Size_T count ) noexcept
+        {
+            Size_T k = 0;
+
+            while( (k < count) && (buffer_pos_ < BlockSize) )
+            {
+                a[k++] = buffer_[buffer_pos_++];
+            }
+
+            while( k + BlockSize <= count )
+            {
+                Block( &a[k] );
+
+                k += BlockSize;
+            }
+
+            while( k < count )
+            {
+                a[k++] = (*this)();
+            }
+        }
+
+        static constexpr result_type min() noexcept
+        {
+            return std::numeric_limits<result_type>::min();
+        }
+
+        static constexpr result_type max() noexcept
+        {
+            return std::numeric_limits<result_type>::max();
+        }
+
+        std::string ClassName()
+        {
+            return std::string("Philox4x32");
+        }
+
+    private:
+
+        // Evaluates Philox4x32-10 on the counters position_, ..., position_ + CountersPerBlock - 1 and advances position_.
+        void Block( mptr<result_type> a ) noexcept
+        {
+            constexpr Size_T L = CountersPerBlock;
+
+            // Structure of arrays, so that the loops over the lanes vectorize.
+            std::uint32_t c_0 [L];
+            std::uint32_t c_1 [L];
+            std::uint32_t c_2 [L];
+            std::uint32_t c_3 [L];
+
+            for( Size_T l = 0; l < L; ++l )
+            {
+                const std::uint64_t pos = position_ + l;
+
+                c_0[l] = static_cast<std::uint32_t>(pos          );
+                c_1[l] = static_cast<std::uint32_t>(pos     >> 32);
+                c_2[l] = static_cast<std::uint32_t>(sample_index_      );
+                c_3[l] = static_cast<std::uint32_t>(sample_index_ >> 32);
+            }
+
+            std::uint32_t k_0 = static_cast<std::uint32_t>(seed_      );
+            std::uint32_t k_1 = static_cast<std::uint32_t>(seed_ >> 32);
+
+            for( int round = 0; round < RoundCount; ++round )
+            {
+                for( Size_T l = 0; l < L; ++l )
+                {
+                    const std::uint64_t p_0 = static_cast<std::uint64_t>(M_0) * c_0[l];
+                    const std::uint64_t p_1 = static_cast<std::uint64_t>(M_1) * c_2[l];
+
+                    const std::uint32_t hi_0 = static_cast<std::uint32_t>(p_0 >> 32);
+                    const std::uint32_t lo_0 = static_cast<std::uint32_t>(p_0      );
+                    const std::uint32_t hi_1 = static_cast<std::uint32_t>(p_1 >> 32);
+                    const std::uint32_t lo_1 = static_cast<std::uint32_t>(p_1      );
+
+                    c_0[l] = hi_1 ^ c_1[l] ^ k_0;
+                    c_1[l] = lo_1;
+                    c_2[l] = hi_0 ^ c_3[l] ^ k_1;
+                    c_3[l] = lo_0;
+                }
+
+                k_0 += W_0;
+                k_1 += W_1;
+            }
+
+            for( Size_T l = 0; l < L; ++l )
+            {
+                a[WordsPerCounter * l + 0] = (static_cast<std::uint64_t>(c_1[l]) << 32) | c_0[l];
+                a[WordsPerCounter * l + 1] = (static_cast<std::uint64_t>(c_3[l]) << 32) | c_2[l];
+            }
+
+            position_ += L;
+        }
+
+    }; // class Philox4x32
+
+} // namespace CoBarS
@@ -0,0 +1,300 @@
+#pragma once
+
+// A native binary file format for random closed polygons and their sampling weights; see Sampler::CreateRandomClosedPolygonsFile for the writer and CoBarS::PolygonFile for the reader.
+//
+// Layout (all numbers in native byte order):
+//
+//     PolygonFileHeader
+//     r     -- edge_count Reals; the edge lengths
+//     rho   -- edge_count Reals; the weights of the Riemannian metric
+//     q     -- sample_count records of (edge_count + 1) * amb_dim Reals; the vertex positions
+//     K_edge_space -- sample_count Reals; the sampling weights, or their logarithms if header.log_weights is set
+//     K_quot_space -- sample_count Reals; likewise
+//
+// The vertex positions are stored exactly as CreateRandomClosedPolygons stores them in memory, and their section starts on a 64 KiB boundary, a multiple of the page size on all common platforms (4 KiB on x86-64, 16 KiB on Apple Silicon, up to 64 KiB on arm64 Linux). So a memory-mapped file can be passed directly to ComputeConformalClosures, ReadInitialVertexPositions, etc.
+
+namespace CoBarS
+{
+
+    /*!
+     * @brief The header of a file written by `CoBarS::Sampler::CreateRandomClosedPolygonsFile`. All offsets are in bytes from the beginning of the file.
+     */
+
+    struct PolygonFileHeader
+    {
+        static constexpr char          Magic [8] = { 'C','o','B','a','r','S','P','F' };
+        static constexpr std::uint32_t Version   = 2;
+
+        char          magic [8]          = {};
+        std::uint32_t version            = 0;
+        std::uint32_t header_size        = 0;
+
+        std::uint32_t amb_dim            = 0;
+        std::uint32_t real_size          = 0;
+        std::uint64_t edge_count         = 0;
+        std::uint64_t sample_count       = 0;
+
+        std::uint64_t r_offset           = 0;
+        std::uint64_t rho_offset         = 0;
+        std::uint64_t q_offset           = 0;
+        std::uint64_t K_edge_offset      = 0;
+        std::uint64_t K_quot_offset      = 0;
+        std::uint64_t file_size          = 0;
+
+        char          prng [32]          = {};
+
+        // The relevant part of SamplerSettings.
+        std::uint64_t use_seed           = 0;
+        std::uint64_t seed               = 0;
+        std::uint64_t samples_per_stream = 0;
+        std::uint64_t max_iter           = 0;
+        std::uint64_t max_backtrackings  = 0;
+        std::uint64_t use_linesearch     = 0;
+        // If set, the K_edge_space and K_quot_space sections hold the logarithms of the sampling weights (see SamplerSettings::log_weights).
+        std::uint64_t log_weights        = 0;
+        double        tolerance            = 0;
+        double        give_up_tolerance    = 0;
+        double        regularization       = 0;
+        double        Armijo_slope_factor  = 0;
+        double        Armijo_shrink_factor = 0;
+
+        bool ValidQ() const
+        {
+            return (std::memcmp( magic, Magic, sizeof(Magic) ) == 0)
+                && (version == Version)
+                && (header_size == sizeof(PolygonFileHeader));
+        }
+
+        /*!
+         * @brief Fills in the magic number, the sizes, and all offsets for the given dimensions.
+         */
+
+        void SetLayout(
+            const std::uint32_t d, const std::uint32_t real_size_,
+            const std::uint64_t edge_count_, const std::uint64_t sample_count_
+        )
+        {
+            // Not the page size of this machine, so that files stay portable.
+            constexpr std::uint64_t page = 65536;
+            constexpr std::uint64_t line = 64;
+
+            auto round_up = []( const std::uint64_t x, const std::uint64_t a )
+            {
+                return a * ( (x + a - 1) / a );
+            };
+
+            std::memcpy( magic, Magic, sizeof(Magic) );
+
+            version      = Version;
+            header_size  = sizeof(PolygonFileHeader);
+            amb_dim      = d;
+            real_size    = real_size_;
+            edge_count   = edge_count_;
+            sample_count = sample_count_;
+
+            const std::uint64_t record_size = (edge_count + 1) * amb_dim * real_size;
+
+            r_offset      = round_up( header_size, line );
+            rho_offset    = round_up( r_offset   + edge_count * real_size, line );
+            q_offset      = round_up( rho_offset + edge_count * real_size, page );
+            K_edge_offset = round_up( q_offset   + sample_count * record_size, line );
+            K_quot_offset = round_up( K_edge_offset + sample_count * real_size, line );
+            file_size     = K_quot_offset + sample_count * real_size;
+        }
+    };
+
+    static_assert( std::is_trivially_copyable_v<PolygonFileHeader>, "" );
+
+
+    /*!
+     * @brief A read-only, zero-copy view of a file written by `CoBarS::Sampler::CreateRandomClosedPolygonsFile`.
+     *
+     * The file is memory-mapped; the pointers returned by `VertexPositions`, `EdgeSpaceSamplingWeights`, etc. point directly into the mapping and stay valid as long as this object lives. Pages are loaded by the operating system on first access.
+     *
+     * Example: use the stored polygons as input for the conformal closure, without copying them:
+     *
+     *     CoBarS::PolygonFile<double,std::size_t> file ( "polygons.cobars" );
+     *
+     *     CoBarS::Sampler<3> S ( file.EdgeLengths(), file.Rho(), file.EdgeCount() );
+     *
+     *     S.ComputeConformalClosures( file.VertexPositions(), w, q, K_edge, K_quot, file.SampleCount(), thread_count );
+     */
+
+    template<typename Real, typename Int>
+    class PolygonFile
+    {
+    private:
+
+        PolygonFileHeader header;
+
+        int    file_descriptor = -1;
+        void * map             = nullptr;
+        Size_T map_size        = 0;
+
+    public:
+
+        explicit PolygonFile( const std::string & path )
+        {
+            file_descriptor = ::open( path.c_str(), O_RDONLY );
+
+            if( file_descriptor < 0 )
+            {
+                eprint( ClassName() + ": Could not open file " + path + "." );
+                return;
+            }
+
+            struct stat info;
+
+            if( (::fstat( file_descriptor, &info ) != 0) || (static_cast<Size_T>(info.st_size) < sizeof(PolygonFileHeader)) )
+            {
+                eprint( ClassName() + ": File " + path + " is too small to be a polygon file." );
+                Close();
+                return;
+            }
+
+            map_size = static_cast<Size_T>(info.st_size);
+
+            map = ::mmap( nullptr, map_size, PROT_READ, MAP_SHARED, file_descriptor, 0 );
+
+            if( map == MAP_FAILED )
+            {
+                map = nullptr;
+                eprint( ClassName() + ": Could not map file " + path + " into memory." );
+                Close();
+                return;
+            }
+
+            std::memcpy( &header, map, sizeof(PolygonFileHeader) );
+
+            if( !header.ValidQ() )
+            {
+                eprint( ClassName() + ": File " + path + " is not a polygon file of version " + ToString(PolygonFileHeader::Version) + "." );
+                Close();
+                return;
+            }
+
+            if( header.real_size != sizeof(Real) )
+            {
+                eprint( ClassName() + ": File " + path + " stores floating point numbers of " + ToString(header.real_size) + " bytes, but Real has " + ToString(sizeof(Real)) + " bytes." );
+                Close();
+                return;
+            }
+
+            if( header.file_size > map_size )
+            {
+                eprint( ClassName() + ": File " + path + " is truncated." );
+                Close();
+                return;
+            }
+        }
+
+        ~PolygonFile()
+        {
+            Close();
+        }
+
+        PolygonFile( const PolygonFile & other ) = delete;
+
+        PolygonFile & operator=( const PolygonFile & other ) = delete;
+
+
+        bool ValidQ() const
+        {
+            return map != nullptr;
+        }
+
+        const PolygonFileHeader & Header() const
+        {
+            return header;
+        }
+
+        Int AmbientDimension() const
+        {
+            return static_cast<Int>(header.amb_dim);
+        }
+
+        Int EdgeCount() const
+        {
+            return static_cast<Int>(header.edge_count);
+        }
+
+        Int SampleCount() const
+        {
+            return static_cast<Int>(header.sample_count);
+        }
+
+        std::string PRNG_Name() const
+        {
+            return std::string( header.prng, strnlen( header.prng, sizeof(header.prng) ) );
+        }
+
+        const Real * EdgeLengths() const
+        {
+            return Section( header.r_offset );
+        }
+
+        const Real * Rho() const
+        {
+            return Section( header.rho_offset );
+        }
+
+        /*!
+         * @brief The vertex positions of all polygons. The `j`-th coordinate of the `i`-th vertex of the `k`-th polygon is stored at position `(n + 1) * d * k + d * i + j`, where `n = EdgeCount()` and `d = AmbientDimension()`.
+         */
+
+        const Real * VertexPositions() const
+        {
+            return Section( header.q_offset );
+        }
+
+        /*!
+         * @brief Whether `EdgeSpaceSamplingWeights` and `EdgeQuotientSpaceSamplingWeights` hold the logarithms of the sampling weights, i.e., whether the file was written with `SamplerSettings::log_weights` set.
+         */
+
+        bool LogWeightsQ() const
+        {
+            return header.log_weights != 0;
+        }
+
+        const Real * EdgeSpaceSamplingWeights() const
+        {
+            return Section( header.K_edge_offset );
+        }
+
+        const Real * EdgeQuotientSpaceSamplingWeights() const
+        {
+            return Section( header.K_quot_offset );
+        }
+
+        std::string ClassName() const
+        {
+            return std::string("CoBarS::PolygonFile") + "<" + TypeName<Real> + "," + TypeName<Int> + ">";
+        }
+
+    private:
+
+        const Real * Section( const std::uint64_t offset ) const
+        {
+            return (map == nullptr)
+                ? nullptr
+                : reinterpret_cast<const Real *>( static_cast<const char *>(map) + offset );
+        }
+
+        void Close()
+        {
+            if( map != nullptr )
+            {
+                ::munmap( map, map_size );
+                map = nullptr;
+            }
+
+            if( file_descriptor >= 0 )
+            {
+                ::close( file_descriptor );
+                file_descriptor = -1;
+            }
+        }
+
+    }; // class PolygonFile
+
+} // namespace CoBarS
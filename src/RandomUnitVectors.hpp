@@ -0,0 +1,253 @@
+#pragma once
+
+namespace CoBarS
+{
+
+/*!
+ * @brief Returns the number of `Real`s of scratch space that `RandomUnitVectors` needs to generate `count` unit vectors.
+ *
+ * @tparam AmbDim The dimension of the ambient space.
+ */
+
+    template<int AmbDim, typename Int>
+    constexpr Int RandomUnitVectorsBufferSize( const Int count )
+    {
+        if constexpr ( AmbDim == 2 )
+        {
+            return count;
+        }
+        else if constexpr ( AmbDim == 3 )
+        {
+            return Int(2) * count;
+        }
+        else if constexpr ( AmbDim == 4 )
+        {
+            return Int(3) * count;
+        }
+        else
+        {
+            // Box-Muller transform generates normally distributed numbers in pairs.
+            return Int(2) * ( ( Int(AmbDim) * count + Int(1) ) / Int(2) );
+        }
+    }
+
+/*!
+ * @brief Fills `u` with `count` uniformly distributed numbers from [0,1).
+ *
+ * The raw 64-bit words of `engine` are converted by taking their highest `std::numeric_limits<Real>::digits` bits; this works with all pseudorandom number generators in CoBarS (`MT64`, `PCG64`, `Philox4x32`, `WyRand`, `Xoshiro256Plus`). If the engine can write many words at once (as `Philox4x32` can), this is used.
+ */
+
+    template<typename Real, typename Int, typename PRNG_T>
+    void RandomUniforms( PRNG_T & engine, mptr<Real> u, const Int count )
+    {
+        static_assert(FloatQ<Real>,"");
+        static_assert(IntQ<Int>,"");
+
+        static_assert(
+            (PRNG_T::min() == 0) && (PRNG_T::max() == std::numeric_limits<std::uint64_t>::max()),
+            "RandomUniforms requires a pseudorandom number generator that produces full 64-bit words."
+        );
+
+        constexpr int bits = std::numeric_limits<Real>::digits;
+
+        constexpr Real scale = Real(1) / static_cast<Real>( std::uint64_t(1) << bits );
+
+        constexpr int shift = 64 - bits;
+
+        if constexpr (
+            requires ( PRNG_T & e, mptr<std::uint64_t> a, Size_T m ) { e( a, m ); }
+        )
+        {
+            // The engine can write many words at once (e.g., CoBarS::Philox4x32).
+            constexpr Int chunk_size = 64;
+
+            std::uint64_t words [chunk_size];
+
+            for( Int k = 0; k < count; k += chunk_size )
+            {
+                const Int m = std::min( chunk_size, count - k );
+
+                engine( &words[0], static_cast<Size_T>(m) );
+
+                for( Int i = 0; i < m; ++i )
+                {
+                    u[k + i] = scale * static_cast<Real>( words[i] >> shift );
+                }
+            }
+        }
+        else
+        {
+            for( Int k = 0; k < count; ++k )
+            {
+                u[k] = scale * static_cast<Real>( static_cast<std::uint64_t>( engine() ) >> shift );
+            }
+        }
+    }
+
+/*!
+ * @brief Computes `c = cos(2 pi u)` and `s = sin(2 pi u)` for `u` in [0,1).
+ *
+ * In contrast to `std::cos` and `std::sin`, this is branch-free and does not call into the math library, so that loops over it can be vectorized. The argument is reduced to [-pi/4,pi/4] and a quadrant; the Taylor polynomials used on [-pi/4,pi/4] are accurate to machine precision.
+ */
+
+    template<typename Real>
+    inline void CosSin2Pi( const Real u, Real & c, Real & s )
+    {
+        constexpr Real half    = Real(1)/Real(2);
+        constexpr Real half_pi = Scalar::Pi<Real> / Real(2);
+
+        const Real t = Real(4) * u;
+        const Real q = std::floor( t + half );
+        const Real x = half_pi * ( t - q );
+        const Real y = x * x;
+
+        const Real sin_x = x * ( Real(1) + y * ( Real(-1)/Real(6) + y * ( Real(1)/Real(120) + y * ( Real(-1)/Real(5040) + y * ( Real(1)/Real(362880) + y * ( Real(-1)/Real(39916800) + y * ( Real(1)/Real(6227020800) + y * ( Real(-1)/Real(1307674368000) + y * ( Real(1)/Real(355687428096000) ) ) ) ) ) ) ) ) );
+
+        const Real cos_x = Real(1) + y * ( Real(-1)/Real(2) + y * ( Real(1)/Real(24) + y * ( Real(-1)/Real(720) + y * ( Real(1)/Real(40320) + y * ( Real(-1)/Real(3628800) + y * ( Real(1)/Real(479001600) + y * ( Real(-1)/Real(87178291200) + y * ( Real(1)/Real(20922789888000) ) ) ) ) ) ) ) );
+
+        // The quadrant; q = 4 is the same as q = 0.
+        const int k = static_cast<int>(q) & 3;
+
+        const Real c_abs = (k & 1) ? sin_x : cos_x;
+        const Real s_abs = (k & 1) ? cos_x : sin_x;
+
+        c = ( (k == 1) || (k == 2) ) ? -c_abs : c_abs;
+        s = ( k >= 2 )               ? -s_abs : s_abs;
+    }
+
+/*!
+ * @brief Transforms `RandomUnitVectorsBufferSize<AmbDim>(count)` numbers from [0,1) in `buffer` into `count` points on the unit sphere in dimension `AmbDim`, by the maps described in `RandomUnitVectors`.
+ *
+ * If the numbers in `buffer` are independent and uniformly distributed, then so are the points. The maps for `AmbDim` = 2, 3, 4 preserve volume, so they can also be fed with quasi-random points (see `CoBarS::ScrambledSobol`). The contents of `buffer` are overwritten.
+ */
+
+    template<int AmbDim, typename Real, typename Int, typename Store_T>
+    void UniformsToUnitVectors( mptr<Real> buffer, const Int count, Store_T && store )
+    {
+        static_assert( AmbDim > 1, "" );
+
+        constexpr Real one = 1;
+        constexpr Real two = 2;
+
+        if constexpr ( AmbDim == 2 )
+        {
+            for( Int i = 0; i < count; ++i )
+            {
+                Real c;
+                Real s;
+
+                CosSin2Pi( buffer[i], c, s );
+
+                store( i, Int(0), c );
+                store( i, Int(1), s );
+            }
+        }
+        else if constexpr ( AmbDim == 3 )
+        {
+            for( Int i = 0; i < count; ++i )
+            {
+                Real c;
+                Real s;
+
+                CosSin2Pi( buffer[2 * i + 1], c, s );
+
+                const Real z   = two * buffer[2 * i + 0] - one;
+                const Real rad = std::sqrt( std::max( one - z * z, Real(0) ) );
+
+                store( i, Int(0), rad * c );
+                store( i, Int(1), rad * s );
+                store( i, Int(2), z );
+            }
+        }
+        else if constexpr ( AmbDim == 4 )
+        {
+            for( Int i = 0; i < count; ++i )
+            {
+                Real c_0;
+                Real s_0;
+                Real c_1;
+                Real s_1;
+
+                CosSin2Pi( buffer[3 * i + 1], c_0, s_0 );
+                CosSin2Pi( buffer[3 * i + 2], c_1, s_1 );
+
+                const Real rad_0 = std::sqrt( buffer[3 * i + 0] );
+                const Real rad_1 = std::sqrt( one - buffer[3 * i + 0] );
+
+                store( i, Int(0), rad_0 * c_0 );
+                store( i, Int(1), rad_0 * s_0 );
+                store( i, Int(2), rad_1 * c_1 );
+                store( i, Int(3), rad_1 * s_1 );
+            }
+        }
+        else
+        {
+            const Int pair_count = RandomUnitVectorsBufferSize<AmbDim>(count) / Int(2);
+
+            // Box-Muller transform, in place. We use 1 - u in (0,1] to avoid log(0).
+            for( Int k = 0; k < pair_count; ++k )
+            {
+                Real c;
+                Real s;
+
+                CosSin2Pi( buffer[2 * k + 1], c, s );
+
+                const Real rad = std::sqrt( - two * std::log( one - buffer[2 * k + 0] ) );
+
+                buffer[2 * k + 0] = rad * c;
+                buffer[2 * k + 1] = rad * s;
+            }
+
+            for( Int i = 0; i < count; ++i )
+            {
+                cptr<Real> g = &buffer[AmbDim * i];
+
+                Real gg = 0;
+
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    gg += g[j] * g[j];
+                }
+
+                const Real factor = one / std::sqrt(gg);
+
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    store( i, j, factor * g[j] );
+                }
+            }
+        }
+    }
+
+/*!
+ * @brief Generates `count` independent, uniformly distributed random points on the unit sphere in dimension `AmbDim` in one go.
+ *
+ * First, a block of uniformly distributed numbers is drawn from `engine` into `buffer`; then all of them are transformed by a branch-free loop that the compiler can vectorize:
+ *  - `AmbDim == 2`: a uniformly distributed angle;
+ *  - `AmbDim == 3`: a uniformly distributed z-coordinate and a uniformly distributed azimuth (Archimedes' theorem);
+ *  - `AmbDim == 4`: Hopf coordinates, i.e., two uniformly distributed angles and a uniformly distributed squared radius of the first pair of coordinates;
+ *  - otherwise: normally distributed coordinates by the Box-Muller transform, followed by a normalization.
+ *
+ * Except for the last case, no normalization and no calls to the math library other than `std::sqrt` are needed.
+ *
+ * @param engine The pseudorandom number generator.
+ *
+ * @param buffer Scratch space; assumed to be of size at least `RandomUnitVectorsBufferSize<AmbDim>(count)`.
+ *
+ * @param count Number of unit vectors to generate.
+ *
+ * @param store A callable such that `store(i,j,value)` stores the `j`-th coordinate of the `i`-th unit vector. This allows to write to any memory layout.
+ */
+
+    template<int AmbDim, typename Real, typename Int, typename PRNG_T, typename Store_T>
+    void RandomUnitVectors(
+        PRNG_T & engine, mptr<Real> buffer, const Int count, Store_T && store
+    )
+    {
+        RandomUniforms( engine, buffer, RandomUnitVectorsBufferSize<AmbDim>(count) );
+
+        UniformsToUnitVectors<AmbDim>( buffer, count, std::forward<Store_T>(store) );
+    }
+
+
+} // namespace CoBarS
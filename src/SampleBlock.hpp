@@ -0,0 +1,126 @@
+#pragma once
+
+namespace CoBarS
+{
+
+    /*!
+     * @brief A block of consecutive samples, as handed to the sink of `CoBarS::Sampler::StreamSample`.
+     *
+     * The block holds the samples `Begin()`, ..., `Begin() + Count() - 1`. Sample `Begin() + k` has
+     *
+     *  - its vertex positions at `VertexPositions() + k * VertexSize()` (if polygons are stored; otherwise `VertexPositions()` is `nullptr`);
+     *
+     *  - its sampling weights at `EdgeSpaceSamplingWeights()[k]` and `EdgeQuotientSpaceSamplingWeights()[k]`;
+     *
+     *  - the values of its random variables at `SampledValues() + k * FunCount()`.
+     *
+     * The memory layouts are the same as for `CreateRandomClosedPolygons` and `Sample`.
+     */
+
+    template<typename Real, typename Int>
+    class SampleBlock
+    {
+    private:
+
+        Int begin       = 0;
+        Int count       = 0;
+        Int capacity    = 0;
+        Int vertex_size = 0;
+        Int fun_count   = 0;
+
+        Tensor1<Real,Int> q;
+        Tensor1<Real,Int> K_edge_space;
+        Tensor1<Real,Int> K_quot_space;
+        Tensor1<Real,Int> values;
+
+    public:
+
+        SampleBlock(
+            const Int capacity_, const Int vertex_size_, const Int fun_count_
+        )
+        :   capacity     ( capacity_    )
+        ,   vertex_size  ( vertex_size_ )
+        ,   fun_count    ( fun_count_   )
+        ,   q            ( capacity * vertex_size )
+        ,   K_edge_space ( capacity )
+        ,   K_quot_space ( capacity )
+        ,   values       ( capacity * fun_count )
+        {}
+
+        ~SampleBlock() = default;
+
+
+        Int Begin() const
+        {
+            return begin;
+        }
+
+        Int Count() const
+        {
+            return count;
+        }
+
+        Int Capacity() const
+        {
+            return capacity;
+        }
+
+        Int VertexSize() const
+        {
+            return vertex_size;
+        }
+
+        Int FunCount() const
+        {
+            return fun_count;
+        }
+
+        void SetRange( const Int begin_, const Int count_ )
+        {
+            begin = begin_;
+            count = std::min( count_, capacity );
+        }
+
+        Real * VertexPositions()
+        {
+            return (vertex_size > 0) ? q.data() : nullptr;
+        }
+
+        const Real * VertexPositions() const
+        {
+            return (vertex_size > 0) ? q.data() : nullptr;
+        }
+
+        Real * EdgeSpaceSamplingWeights()
+        {
+            return K_edge_space.data();
+        }
+
+        const Real * EdgeSpaceSamplingWeights() const
+        {
+            return K_edge_space.data();
+        }
+
+        Real * EdgeQuotientSpaceSamplingWeights()
+        {
+            return K_quot_space.data();
+        }
+
+        const Real * EdgeQuotientSpaceSamplingWeights() const
+        {
+            return K_quot_space.data();
+        }
+
+        Real * SampledValues()
+        {
+            return values.data();
+        }
+
+        const Real * SampledValues() const
+        {
+            return values.data();
+        }
+
+    }; // class SampleBlock
+
+} // namespace CoBarS
@@ -2,6 +2,8 @@
 
 namespace CoBarS
 {
+    template<int AMB_DIM, typename REAL, typename INT, typename PRNG_T, int LANES>
+    class BatchSampler;
     
 /*!
  * @brief The main class of CoBarS. It does the actual sampling.
@@ -19,8 +21,11 @@ namespace CoBarS
  * Possible values are
  *  - CoBarS::MT64
  *  - CoBarS::PCG64
+ *  - CoBarS::Philox4x32
  *  - CoBarS::WyRand
  *  - CoBarS::Xoshiro256Plus
+ *
+ * @tparam EDGE_COUNT If positive, the number of edges is fixed at compile time: The edge vectors and vertex positions are kept in fixed-size arrays inside the object (see `CoBarS::FixedVectorList`), and all loops over the edges have compile-time trip counts, so that the compiler can unroll them. The constructors must then be called with `edge_count == EDGE_COUNT`; otherwise they throw `std::invalid_argument` before allocating anything. `CoBarS::MakeSampler` picks such an instantiation at runtime for common edge counts.
  */
     
     template<
@@ -29,7 +34,8 @@ namespace CoBarS
         typename INT     = std::size_t,
         typename PRNG_T  = Xoshiro256Plus,
         bool VECTORIZE_Q   = true,
-        bool ZEROFY_FIRST_Q = false
+        bool ZEROFY_FIRST_Q = false,
+        int EDGE_COUNT      = 0
     >
     class Sampler : public SamplerBase<AMB_DIM,REAL,INT>
     {
@@ -39,7 +45,7 @@ namespace CoBarS
 
     private:
         
-        using Class_T = Sampler<AMB_DIM,REAL,INT,PRNG_T,VECTORIZE_Q,ZEROFY_FIRST_Q>;
+        using Class_T = Sampler<AMB_DIM,REAL,INT,PRNG_T,VECTORIZE_Q,ZEROFY_FIRST_Q,EDGE_COUNT>;
         using Base_T  = SamplerBase<AMB_DIM,REAL,INT>;
 
     public:
@@ -67,9 +73,43 @@ namespace CoBarS
         static constexpr bool vectorizeQ   = VECTORIZE_Q   ;
         static constexpr bool zerofyfirstQ = ZEROFY_FIRST_Q;
         
+        static_assert( EDGE_COUNT >= 0, "" );
+        
+        static constexpr bool fixedQ = (EDGE_COUNT > 0);
+        
+        static constexpr Int FixedEdgeCount = static_cast<Int>(EDGE_COUNT);
+        
+        using EdgeList_T   = std::conditional_t<fixedQ,
+            FixedVectorList<AMB_DIM,EDGE_COUNT,Real,Int,vectorizeQ>,
+            std::conditional_t<vectorizeQ, VectorList_T, Matrix_T>
+        >;
+        
+        using VertexList_T = std::conditional_t<fixedQ,
+            FixedVectorList<AMB_DIM,EDGE_COUNT+1,Real,Int,vectorizeQ>,
+            std::conditional_t<vectorizeQ, VectorList_T, Matrix_T>
+        >;
+        
         
         template<int D, typename R, typename I, typename P>
         friend class DouadyEarleExtension;
+        
+        template<int D, typename R, typename I, typename P, int L>
+        friend class BatchSampler;
+        
+        /*!
+         * @brief Number of polygons that are closed simultaneously if `Settings().use_batch_engine` is set. This is the number of `Real`s that fit into a 256 bit SIMD register.
+         */
+        
+        static constexpr int BatchLanes = static_cast<int>( 32 / sizeof(Real) );
+        
+        using BatchSampler_T = BatchSampler<AMB_DIM,REAL,INT,PRNG_T,BatchLanes>;
+        
+        using ConfidenceState_T = ConfidenceState<Real,Int>;
+        
+        // The number of entries j <= k <= l of a symmetric AmbDim x AmbDim x AmbDim tensor.
+        static constexpr int ThirdMomentCount = AMB_DIM * (AMB_DIM + 1) * (AMB_DIM + 2) / 6;
+        
+        using ThirdMoment_T = Tiny::Vector<ThirdMomentCount,Real,Int>;
     
     public:
         
@@ -82,16 +122,26 @@ namespace CoBarS
             const Setting_T settings = Setting_T()
         )
         :   Base_T( settings )
-        ,   edge_count_(edge_count)
+        ,   edge_count_( CheckedEdgeCount(edge_count) )
+        ,   random_engine ( InitialRandomEngine( settings ) )
+        ,   random_buffer_ ( RandomUnitVectorsBufferSize<AmbDim>(edge_count_) )
         ,   r_   ( edge_count_, one )
         ,   rho_ ( edge_count_, one )
+        ,   r_over_rho_squared_ ( edge_count_ )
+        ,   rho_squared_        ( edge_count_ )
+        ,   y_dot_u_            ( edge_count_ )
         ,   total_r_inv ( one )
         {            
             PrintWarnings();
             ComputeEdgeSpaceSamplingHelper();
             ComputeEdgeQuotientSpaceSamplingHelper();
+            ComputeEdgeConstants();
             
-            if constexpr ( vectorizeQ )
+            if constexpr ( fixedQ )
+            {
+                // The storage has fixed size already.
+            }
+            else if constexpr ( vectorizeQ )
             {
                 x_ = VectorList_T( edge_count_     );
                 y_ = VectorList_T( edge_count_     );
@@ -112,15 +162,24 @@ namespace CoBarS
             const Setting_T settings = Setting_T()
         )
         :   Base_T      ( settings )
-        ,   edge_count_ (edge_count)
+        ,   edge_count_ ( CheckedEdgeCount(edge_count) )
+        ,   random_engine ( InitialRandomEngine( settings ) )
+        ,   random_buffer_ ( RandomUnitVectorsBufferSize<AmbDim>(edge_count_) )
         ,   r_          ( edge_count_ )
         ,   rho_        ( rho, edge_count_ )
+        ,   r_over_rho_squared_ ( edge_count_ )
+        ,   rho_squared_        ( edge_count_ )
+        ,   y_dot_u_            ( edge_count_ )
         {
             PrintWarnings();
             ComputeEdgeSpaceSamplingHelper();
             ComputeEdgeQuotientSpaceSamplingHelper();
             
-            if constexpr ( vectorizeQ )
+            if constexpr ( fixedQ )
+            {
+                // The storage has fixed size already.
+            }
+            else if constexpr ( vectorizeQ )
             {
                 x_ = VectorList_T( edge_count_     );
                 y_ = VectorList_T( edge_count_     );
@@ -143,26 +202,37 @@ namespace CoBarS
         Sampler( const Sampler & other )
         :   Base_T( other )
         ,   edge_count_( other.edge_count_ )
+        ,   random_buffer_( RandomUnitVectorsBufferSize<AmbDim>(other.edge_count_) )
         ,   x_(other.x_)
         ,   y_(other.y_)
         ,   p_(other.p_)
 //        ,   p_initializedQ(other.p_initializedQ)
         ,   r_(other.r_)
         ,   rho_(other.rho_)
+        ,   r_over_rho_squared_(other.r_over_rho_squared_)
+        ,   rho_squared_(other.rho_squared_)
+        ,   equilateralQ(other.equilateralQ)
+        ,   y_dot_u_(other.y_dot_u_)
         ,   total_r_inv(other.total_r_inv)
         ,   w_(other.w_)
         ,   F_(other.F_)
         ,   DF_(other.DF_)
+        ,   M3_(other.M3_)
         ,   L(other.L)
         ,   u_(other.u_)
         ,   z_(other.z_)
         ,   iter(other.iter)
+        ,   trust_radius(other.trust_radius)
         ,   squared_residual(other.squared_residual)
         ,   residual(other.residual)
         ,   edge_space_sampling_helper              ( other.edge_space_sampling_helper              )
         ,   edge_quotient_space_sampling_helper     ( other.edge_quotient_space_sampling_helper     )
         ,   edge_space_sampling_weight              ( other.edge_space_sampling_weight              )
         ,   edge_quotient_space_sampling_weight     ( other.edge_quotient_space_sampling_weight )
+        ,   edge_space_sampling_log_helper          ( other.edge_space_sampling_log_helper          )
+        ,   edge_quotient_space_sampling_log_helper ( other.edge_quotient_space_sampling_log_helper )
+        ,   edge_space_sampling_log_weight          ( other.edge_space_sampling_log_weight          )
+        ,   edge_quotient_space_sampling_log_weight ( other.edge_quotient_space_sampling_log_weight )
         ,   lambda_min(other.lambda_min)
         ,   q_Newton(other.q_Newton)
         ,   errorestimator(other.errorestimator)
@@ -170,7 +240,10 @@ namespace CoBarS
         ,   succeededQ(other.succeededQ)
         ,   continueQ(other.continueQ)
         ,   ArmijoQ(other.ArmijoQ)
-        ,   moments_(other.moments_)
+        ,   confidence_state_(other.confidence_state_)
+        ,   control_list_(other.control_list_)
+        ,   control_means_(other.control_means_)
+        ,   qmc_(other.qmc_)
         {
             LoadRandomVariables( other.F_list_ );
         }
@@ -183,22 +256,30 @@ namespace CoBarS
         {
             using std::swap;
    
+            swap(A.settings_,B.settings_);
             swap(A.edge_count_,B.edge_count_);
+            swap(A.random_buffer_,B.random_buffer_);
             swap(A.x_,B.x_);
             swap(A.y_,B.y_);
             swap(A.p_,B.p_);
 //            swap(A.p_initializedQ,B.p_initializedQ);
             swap(A.r_,B.r_);
             swap(A.rho_,B.rho_);
+            swap(A.r_over_rho_squared_,B.r_over_rho_squared_);
+            swap(A.rho_squared_,B.rho_squared_);
+            swap(A.equilateralQ,B.equilateralQ);
+            swap(A.y_dot_u_,B.y_dot_u_);
             swap(A.total_r_inv,B.total_r_inv);
             swap(A.w_,B.w_);
             swap(A.F_,B.F_);
             swap(A.DF_,B.DF_);
+            swap(A.M3_,B.M3_);
             swap(A.L,B.L);
             swap(A.u_,B.u_);
             swap(A.z_,B.z_);
 
             swap(A.iter,             B.iter             );
+            swap(A.trust_radius,     B.trust_radius     );
             swap(A.squared_residual, B.squared_residual );
             swap(A.residual,         B.residual         );
             
@@ -207,6 +288,11 @@ namespace CoBarS
             swap(A.edge_space_sampling_weight,          B.edge_space_sampling_weight          );
             swap(A.edge_quotient_space_sampling_weight, B.edge_quotient_space_sampling_weight );
             
+            swap(A.edge_space_sampling_log_helper,          B.edge_space_sampling_log_helper          );
+            swap(A.edge_quotient_space_sampling_log_helper, B.edge_quotient_space_sampling_log_helper );
+            swap(A.edge_space_sampling_log_weight,          B.edge_space_sampling_log_weight          );
+            swap(A.edge_quotient_space_sampling_log_weight, B.edge_quotient_space_sampling_log_weight );
+            
             swap(A.lambda_min,B.lambda_min);
             swap(A.q_Newton,B.q_Newton);
             swap(A.errorestimator,B.errorestimator);
@@ -215,8 +301,15 @@ namespace CoBarS
             swap(A.continueQ,B.continueQ);
             swap(A.ArmijoQ,B.ArmijoQ);
             
-            swap(A.moments_,B.moments_);
+            swap(A.confidence_state_,B.confidence_state_);
+            swap(A.control_list_,B.control_list_);
+            swap(A.control_means_,B.control_means_);
+            swap(A.qmc_,B.qmc_);
             swap(A.F_list_,B.F_list_);
+            swap(A.F_list_origin_,B.F_list_origin_);
+            
+            swap(A.workers_,B.workers_);
+            swap(A.batch_,B.batch_);
         }
         
         /*!
@@ -247,7 +340,7 @@ namespace CoBarS
          * @brief Number of edges in the represented polygon.
          */
         
-        Int edge_count_ = 0;
+        Int edge_count_ = FixedEdgeCount;
         
         /*!
          * @brief The instance's own pseudorandom number generator.
@@ -259,25 +352,89 @@ namespace CoBarS
         
         mutable std::uniform_real_distribution<Real> phi_dist {0,Scalar::TwoPi<Real>};
         
+        /*!
+         * @brief Scratch space for the uniformly distributed random numbers from which `RandomizeInitialEdgeVectors` generates the unit edge vectors.
+         */
+        
+        Tensor1<Real,Int> random_buffer_;
+        
+        static Prng_T InitialRandomEngine( const Setting_T & settings )
+        {
+            // Seeding from std::random_device can be expensive (e.g., for MT64); in reproducible mode we do not need it.
+            return settings.use_seed ? Prng_T( settings.seed, 0 ) : Prng_T();
+        }
+        
         using Base_T::settings_;
 
         /*!
          * @brief The open polyline's unit edge vectors.
          */
         
-        std::conditional_t<vectorizeQ, VectorList_T, Matrix_T> x_;
+        EdgeList_T x_;
         
         /*!
          * @brief The shifted polyline's unit edge vectors. (After the optimization has succeeded: the closed polygon's unit edge vectors.)
          */
         
-        std::conditional_t<vectorizeQ, VectorList_T, Matrix_T> y_;
+        EdgeList_T y_;
         
         /*!
          * @brief The closed polyline's vertex coordinates.
          */
-        mutable std::conditional_t<vectorizeQ, VectorList_T, Matrix_T> p_;
-        
+        mutable VertexList_T p_;
+
+        // The trip count of all loops over the edges. With fixed edge count, it is a compile-time constant.
+
+        Int edgeCount() const
+        {
+            if constexpr ( fixedQ )
+            {
+                return FixedEdgeCount;
+            }
+            else
+            {
+                return edge_count_;
+            }
+        }
+
+        // Reads and writes the i-th vector of x_, y_, or p_. With fixed edge count, we index the array directly, so that the compiler sees the constant strides.
+
+        template<typename List_T>
+        static Vector_T GetVector( const List_T & list, const Int i )
+        {
+            if constexpr ( fixedQ )
+            {
+                Vector_T v;
+
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    v[j] = vectorizeQ ? list[j][i] : list[i][j];
+                }
+
+                return v;
+            }
+            else
+            {
+                return Vector_T( list, i );
+            }
+        }
+
+        template<typename List_T>
+        static void SetVector( const Vector_T & v, List_T & list, const Int i )
+        {
+            if constexpr ( fixedQ )
+            {
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    (vectorizeQ ? list[j][i] : list[i][j]) = v[j];
+                }
+            }
+            else
+            {
+                v.Write( list, i );
+            }
+        }
+
 //        /*!
 //         * @brief Boolean that indicates whether `p_initializedQ` has been recomputed already.
 //         */
@@ -296,6 +453,25 @@ namespace CoBarS
         
         Weights_T rho_ {0};
         
+        /*!
+         * @brief The per-edge factors `(r_[i]/rho_[i])^2` and `rho_[i]^2` of the matrices that enter the sampling weights.
+         */
+        
+        Weights_T r_over_rho_squared_ {0};
+        Weights_T rho_squared_ {0};
+        
+        /*!
+         * @brief Whether all edge lengths are equal.
+         */
+        
+        bool equilateralQ = false;
+        
+        /*!
+         * @brief The dot products of the shifted edge vectors with the search direction `u_`; cached by the line search.
+         */
+        
+        Weights_T y_dot_u_ {0};
+        
         /*!
          * @brief Inverse of the total arc length of the represented polygon.
          */
@@ -320,6 +496,12 @@ namespace CoBarS
         
         SymmetricMatrix_T DF_;
         
+        /*!
+         * @brief The third moment sum_i r_i y_i (x) y_i (x) y_i / sum_i r_i of the shifted edge vectors; only the entries j <= k <= l are stored, in lexicographic order. Only assembled by `SolverStrategy::Chebyshev`.
+         */
+        
+        ThirdMoment_T M3_;
+        
         /*!
          * @brief An auxiliary buffer to store Cholesky factors.
          */
@@ -342,6 +524,12 @@ namespace CoBarS
         
         Int iter = 0;
         
+        /*!
+         * @brief Current radius of the trust region of `SolverStrategy::TrustRegion`.
+         */
+        
+        Real trust_radius = 1;
+        
         Real squared_residual = 1;
         Real         residual = 1;
 
@@ -351,6 +539,12 @@ namespace CoBarS
         mutable Real edge_space_sampling_weight          = -1;
         mutable Real edge_quotient_space_sampling_weight = -1;
         
+        Real edge_space_sampling_log_helper                  = 0;
+        Real edge_quotient_space_sampling_log_helper         = 0;
+        
+        mutable Real edge_space_sampling_log_weight          = 0;
+        mutable Real edge_quotient_space_sampling_log_weight = 0;
+        
         Real lambda_min = eps;
         Real q_Newton = one;
         Real errorestimator = infty;
@@ -376,21 +570,63 @@ namespace CoBarS
         static constexpr Real g_factor_inv      = one/g_factor;
         static constexpr Real norm_threshold    = 0.99 * 0.99 + 16 * eps;
         static constexpr Real two_pi            = Scalar::TwoPi<Real>;
+        
+        // A product of ProductBlockSize factors from [ (1-|v|)^2, (1+|v|)^2 ] with 1 - |v| >= machine epsilon can neither over- nor underflow: For double, (1-|v|)^16 is still a normal number; for float, only (1-|v|)^4 is safe. So instead of one logarithm per factor, we may take one per block.
+        static constexpr Int  ProductBlockSize  = (std::numeric_limits<Real>::max_exponent >= 1024) ? 8 : 2;
 
         
         // TODO: Add copy behavior to these?
         
-        mutable Tensor2<Real,Int> moments_;
+        // The estimator state of the last call to ConfidenceSample.
+        mutable ConfidenceState_T confidence_state_;
+        
+        mutable std::mutex confidence_state_mutex_;
+        
+        // The control variables of ConfidenceSample and their known expectations; see SetControlVariables.
+        std::vector<std::shared_ptr<RandomVariable_T>> control_list_;
+        std::vector<Real> control_means_;
+        
+        // The scrambled Sobol sequences of randomized quasi-Monte Carlo mode (Settings().use_qmc); see PrepareQMC.
+        mutable std::shared_ptr<const ScrambledSobol> qmc_;
+        
         mutable std::vector<std::shared_ptr<RandomVariable_T>> F_list_;
         
+        /*!
+         * @brief The random variables that `F_list_` was cloned from by `LoadRandomVariablesCached`.
+         */
+        
+        mutable std::vector<std::shared_ptr<RandomVariable_T>> F_list_origin_;
+        
+        /*!
+         * @brief Cached per-thread samplers for the sampling routines; see `ReleaseWorkers`.
+         */
+        
+        mutable std::vector<Sampler> workers_;
+        
+        // Set while a sampling routine uses workers_ and qmc_; see WorkerSet.
+        mutable std::atomic<bool> workers_busy_ {false};
+        
+        mutable std::unique_ptr<BatchSampler_T> batch_;
+        
     protected:
         
+#include "Sampler/Planar.hpp"
+
+#include "Sampler/EdgeParallel.hpp"
+
 #include "Sampler/Optimization.hpp"
 
 #include "Sampler/Reweighting.hpp"
         
 #include "Sampler/Methods.hpp"
         
+#include "Sampler/RandomStreams.hpp"
+#include "Sampler/SampleScheduler.hpp"
+#include "Sampler/Workers.hpp"
+#include "Sampler/Accumulators.hpp"
+#include "Sampler/Checkpoint.hpp"
+#include "Sampler/ClosedPolygonLoop.hpp"
+        
 #include "Sampler/CreatePolygons.hpp"
         
 #include "Sampler/ConformalClosure.hpp"
@@ -402,13 +638,27 @@ namespace CoBarS
 #include "Sampler/RandomClosedPolygons.hpp"
 
 #include "Sampler/RandomCentralizedPointClouds.hpp"
+
+#include "Sampler/CompactOutput.hpp"
         
 #include "Sampler/Sample.hpp"
+
+#include "Sampler/StreamSample.hpp"
+
+#ifdef COBARS_POSIX
+#include "Sampler/PolygonFileOutput.hpp"
+#endif
+
+#include "Sampler/Replay.hpp"
         
 #include "Sampler/BinnedSample.hpp"
         
 #include "Sampler/ConfidenceSample.hpp"
 
+#ifdef COBARS_POSIX
+#include "Sampler/ShardedConfidenceSample.hpp"
+#endif
+
         
     public:
         
@@ -419,7 +669,7 @@ namespace CoBarS
         
         virtual Vector_T InitialEdgeVector( const Int i ) const override
         {
-            return Vector_T (x_,i);
+            return GetVector( x_, i );
         }
 
         virtual void ReadInitialEdgeVectors(
@@ -430,13 +680,13 @@ namespace CoBarS
             
             if( normalizeQ )
             {
-                for( Int i = 0; i < edge_count_; ++i )
+                for( Int i = 0; i < edgeCount(); ++i )
                 {
                     Vector_T x_i (X,i);
                     
                     x_i.Normalize();
                     
-                    x_i.Write(x_,i);
+                    SetVector( x_i, x_, i );
                 }
             }
             else
@@ -451,7 +701,7 @@ namespace CoBarS
         {
             cptr<Real> P = &p[AmbDim * (edge_count_ + Int(1)) * offset];
             
-            for( Int i = 0; i < edge_count_; ++i )
+            for( Int i = 0; i < edgeCount(); ++i )
             {
                 cptr<Real> u = &P[AmbDim * (i + 0) ];
                 cptr<Real> v = &P[AmbDim * (i + 1) ];
@@ -465,7 +715,7 @@ namespace CoBarS
 
                 x_i.Normalize();
                 
-                x_i.Write( x_, i );
+                SetVector( x_i, x_, i );
             }
         }
         
@@ -485,9 +735,9 @@ namespace CoBarS
             Vector_T barycenter        (zero);
             Vector_T point_accumulator (zero);
             
-            for( Int i = 0; i < edge_count_; ++i )
+            for( Int i = 0; i < edgeCount(); ++i )
             {
-                const Vector_T x_i ( x_, i );
+                const Vector_T x_i = GetVector( x_, i );
                 
                 const Real r_i = r_[i];
                 
@@ -512,9 +762,9 @@ namespace CoBarS
         
             point_accumulator.Write( &p_out[0] );
             
-            for( Int i = 0; i < edge_count_; ++i )
+            for( Int i = 0; i < edgeCount(); ++i )
             {
-                const Vector_T x_i ( x_, i );
+                const Vector_T x_i = GetVector( x_, i );
                 
                 const Real r_i = r_[i];
                 
@@ -543,9 +793,77 @@ namespace CoBarS
             }
         }
         
+        /*!
+         * @brief Fills the open polyline's unit edge vectors with independent, uniformly distributed random points on the unit sphere.
+         *
+         * The random numbers are drawn in a single block and then transformed by `CoBarS::RandomUnitVectors`.
+         */
+        
         virtual void RandomizeInitialEdgeVectors() override
         {
-            for( Int i = 0; i < edge_count_; ++i )
+            if constexpr ( vectorizeQ )
+            {
+                RandomUnitVectors<AmbDim>(
+                    random_engine, random_buffer_.data(), edge_count_,
+                    [this]( const Int i, const Int j, const Real value )
+                    {
+                        x_[j][i] = value;
+                    }
+                );
+            }
+            else
+            {
+                RandomUnitVectors<AmbDim>(
+                    random_engine, random_buffer_.data(), edge_count_,
+                    [this]( const Int i, const Int j, const Real value )
+                    {
+                        x_[i][j] = value;
+                    }
+                );
+            }
+        }
+        
+        /*!
+         * @brief Fills the open polyline's unit edge vectors from the sample with index `k` of the scrambled Sobol sequences `qmc`, instead of from the random engine.
+         *
+         * `qmc` must have dimension `RandomUnitVectorsBufferSize<AmbDim>(EdgeCount())`; its points are transformed by `CoBarS::UniformsToUnitVectors`.
+         */
+        
+        void QuasiRandomizeInitialEdgeVectors( const ScrambledSobol & qmc, const Int k )
+        {
+            qmc.Sample( k, random_buffer_.data() );
+            
+            if constexpr ( vectorizeQ )
+            {
+                UniformsToUnitVectors<AmbDim>(
+                    random_buffer_.data(), edge_count_,
+                    [this]( const Int i, const Int j, const Real value )
+                    {
+                        x_[j][i] = value;
+                    }
+                );
+            }
+            else
+            {
+                UniformsToUnitVectors<AmbDim>(
+                    random_buffer_.data(), edge_count_,
+                    [this]( const Int i, const Int j, const Real value )
+                    {
+                        x_[i][j] = value;
+                    }
+                );
+            }
+        }
+        
+        /*!
+         * @brief Fills the open polyline's unit edge vectors by normalizing vectors of normally distributed random numbers, one vector at a time.
+         *
+         * This was the original implementation of `RandomizeInitialEdgeVectors`. We keep it for benchmarking; it consumes the random stream differently, so the two routines produce different samples for the same state of the random engine.
+         */
+        
+        void RandomizeInitialEdgeVectors_Gaussian()
+        {
+            for( Int i = 0; i < edgeCount(); ++i )
             {
                 Vector_T x_i;
 
@@ -556,14 +874,14 @@ namespace CoBarS
                 
                 x_i.Normalize();
                 
-                x_i.Write(x_,i);
+                SetVector( x_i, x_, i );
             }
         }
 
         
         virtual Vector_T EdgeVector( const Int i ) const override
         {
-            return Vector_T (y_,i);
+            return GetVector( y_, i );
         }
         
         virtual void WriteEdgeVectors( Real * restrict const y, const Int offset = 0 ) const override
@@ -580,7 +898,7 @@ namespace CoBarS
         
         virtual Vector_T VertexPosition( const Int i ) const override
         {
-            return Vector_T (p_,i);
+            return GetVector( p_, i );
         }
         
         virtual void WriteVertexPositions( Real * restrict const q, const Int offset = 0 ) const override
@@ -592,51 +910,151 @@ namespace CoBarS
         
         virtual void ComputeVertexPositions() const override
         {
-            //Caution: This gives only half the weight to the end vertices of the chain.
-            //Thus this is only really the barycenter, if the chain is closed!
+            if( EdgeThreadCount() <= Int(1) )
+            {
+                //Caution: This gives only half the weight to the end vertices of the chain.
+                //Thus this is only really the barycenter, if the chain is closed!
             
-            // We treat the edges as massless.
-            // All mass is concentrated in the vertices, and each vertex carries the same mass.
-            Vector_T barycenter        (zero);
-            Vector_T point_accumulator (zero);
+                // We treat the edges as massless.
+                // All mass is concentrated in the vertices, and each vertex carries the same mass.
+                Vector_T barycenter        (zero);
+                Vector_T point_accumulator (zero);
             
-            for( Int i = 0; i < edge_count_; ++i )
-            {
-                const Vector_T y_i ( y_, i );
+                for( Int i = 0; i < edgeCount(); ++i )
+                {
+                    const Vector_T y_i = GetVector( y_, i );
                 
-                const Real r_i = r_[i];
+                    const Real r_i = r_[i];
                 
-                for( Int j = 0; j < AmbDim; ++j )
-                {
-                    const Real delta = r_i * y_i[j];
+                    for( Int j = 0; j < AmbDim; ++j )
+                    {
+                        const Real delta = r_i * y_i[j];
                     
-                    barycenter[j] += (point_accumulator[j] + half * delta);
+                        barycenter[j] += (point_accumulator[j] + half * delta);
                     
-                    point_accumulator[j] += delta;
+                        point_accumulator[j] += delta;
+                    }
+                }
+            
+                barycenter *= Inv<Real>( edge_count_ );
+            
+                point_accumulator = barycenter;
+            
+                point_accumulator *= -one;
+            
+                SetVector( point_accumulator, p_, 0 );
+            
+                for( Int i = 0; i < edgeCount(); ++i )
+                {
+                    const Vector_T y_i = GetVector( y_, i );
+                
+                    const Real r_i = r_[i];
+                
+                    for( Int j = 0; j < AmbDim; ++j )
+                    {
+                        point_accumulator[j] += r_i * y_i[j];
+                    }
+                
+                    SetVector( point_accumulator, p_, i + 1 );
                 }
             }
+            else
+            {
+                computeVertexPositions_Parallel();
+            }
+        }
+        
+        void computeVertexPositions_Parallel() const
+        {
+            // A parallel prefix sum in two passes: First each thread sums up the edge vectors of its range of edges and their contributions to the barycenter, as if its range started at the origin. Then each thread writes the vertex positions of its range, starting from the sum over all previous ranges.
             
-            barycenter *= Inv<Real>( edge_count_ );
+            const Int thread_count = EdgeThreadCount();
             
-            point_accumulator = barycenter;
+            std::vector<Vector_T> range_sum        ( thread_count );
+            std::vector<Vector_T> range_barycenter ( thread_count );
+            std::vector<Int>      range_size       ( thread_count );
             
-            point_accumulator *= -one;
+            EdgeParallelDo(
+                [&,this]( const Int thread, const Int i_begin, const Int i_end )
+                {
+                    Vector_T barycenter        (zero);
+                    Vector_T point_accumulator (zero);
+                    
+                    for( Int i = i_begin; i < i_end; ++i )
+                    {
+                        const Vector_T y_i = GetVector( y_, i );
+                        
+                        const Real r_i = r_[i];
+                        
+                        for( Int j = 0; j < AmbDim; ++j )
+                        {
+                            const Real delta = r_i * y_i[j];
+                            
+                            barycenter[j] += (point_accumulator[j] + half * delta);
+                            
+                            point_accumulator[j] += delta;
+                        }
+                    }
+                    
+                    range_sum       [thread] = point_accumulator;
+                    range_barycenter[thread] = barycenter;
+                    range_size      [thread] = i_end - i_begin;
+                }
+            );
             
-            point_accumulator.Write( p_, 0 );
+            // Each vertex of a range is shifted by the sum over all previous ranges.
             
-            for( Int i = 0; i < edge_count_; ++i )
+            std::vector<Vector_T> range_start ( thread_count );
+            
+            Vector_T barycenter        (zero);
+            Vector_T point_accumulator (zero);
+            
+            for( Int thread = 0; thread < thread_count; ++thread )
             {
-                const Vector_T y_i ( y_, i );
+                range_start[thread] = point_accumulator;
                 
-                const Real r_i = r_[i];
+                const Real size = static_cast<Real>( range_size[thread] );
                 
                 for( Int j = 0; j < AmbDim; ++j )
                 {
-                    point_accumulator[j] += r_i * y_i[j];
+                    barycenter[j] += range_barycenter[thread][j] + size * point_accumulator[j];
+                    
+                    point_accumulator[j] += range_sum[thread][j];
+                }
+            }
+            
+            barycenter *= Inv<Real>( edge_count_ );
+            
+            for( Int thread = 0; thread < thread_count; ++thread )
+            {
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    range_start[thread][j] -= barycenter[j];
                 }
-                
-                point_accumulator.Write( p_, i + 1 );
             }
+            
+            SetVector( range_start[0], p_, 0 );
+            
+            EdgeParallelDo(
+                [&,this]( const Int thread, const Int i_begin, const Int i_end )
+                {
+                    Vector_T point_accumulator = range_start[thread];
+                    
+                    for( Int i = i_begin; i < i_end; ++i )
+                    {
+                        const Vector_T y_i = GetVector( y_, i );
+                        
+                        const Real r_i = r_[i];
+                        
+                        for( Int j = 0; j < AmbDim; ++j )
+                        {
+                            point_accumulator[j] += r_i * y_i[j];
+                        }
+                        
+                        SetVector( point_accumulator, p_, i + 1 );
+                    }
+                }
+            );
         }
         
     public:
@@ -654,6 +1072,7 @@ namespace CoBarS
         virtual void LoadRandomVariables( const std::vector<std::shared_ptr<RandomVariable_T>> & F_list ) const override
         {
             F_list_.clear();
+            F_list_origin_.clear();
             
             for( RandomVariable_Ptr F : F_list )
             {
@@ -664,6 +1083,7 @@ namespace CoBarS
         virtual void ClearRandomVariables() const override
         {
             F_list_.clear();
+            F_list_origin_.clear();
         }
 
         virtual Real EvaluateRandomVariable( Int i ) const override
@@ -687,22 +1107,39 @@ namespace CoBarS
 
             Optimize();
             
+            computeSamplingWeights<vertex_pos_Q,quot_space_Q>();
+        }
+        
+        template<bool vertex_pos_Q, bool quot_space_Q>
+        void computeSamplingWeights()
+        {
             if constexpr ( vertex_pos_Q )
             {
                 ComputeVertexPositions();
             }
             
-            ComputeEdgeSpaceSamplingWeight();
-            
-            if constexpr ( quot_space_Q )
-            {
-                ComputeEdgeQuotientSpaceSamplingWeight();
-            }
+            ComputeSamplingWeights<quot_space_Q>();
         }
 
     private:
         
         
+        // With fixed edge count, all loops run over FixedEdgeCount edges. So an instance with another edge count would access memory out of bounds; we must not create it.
+        // This is called from the initializer of edge_count_, when the other members do not exist yet. So it must not touch *this; in particular, ClassName() would call random_engine.ClassName().
+        static Int CheckedEdgeCount( const Int edge_count )
+        {
+            if( fixedQ && (edge_count != FixedEdgeCount) )
+            {
+                const std::string message = std::string("CoBarS::Sampler<") + ToString(AmbDim) + "," + TypeName<Real> + "," + TypeName<Int> + ",...," + ToString(EDGE_COUNT) + ">: This class is made for polygons with " + ToString(FixedEdgeCount) + " edges, but edge_count = " + ToString(edge_count) + ". Use CoBarS::MakeSampler or a Sampler with EDGE_COUNT = 0 instead.";
+                
+                eprint(message);
+                
+                throw std::invalid_argument(message);
+            }
+            
+            return edge_count;
+        }
+        
         void PrintWarnings()
         {
             static_assert( AMB_DIM > 1, "Polygons in ambient dimension AMB_DIM < 2 do not make sense.");
@@ -728,7 +1165,7 @@ namespace CoBarS
         
         std::string ClassName() const override
         {
-            return std::string("CoBarS::Sampler") + "<" + ToString(AmbDim) + "," + TypeName<Real> + "," + TypeName<Int>  + "," + PRNG_Name() + "," + ToString(vectorizeQ) +"," + ToString(zerofyfirstQ) + ">";
+            return std::string("CoBarS::Sampler") + "<" + ToString(AmbDim) + "," + TypeName<Real> + "," + TypeName<Int>  + "," + PRNG_Name() + "," + ToString(vectorizeQ) +"," + ToString(zerofyfirstQ) + (fixedQ ? "," + ToString(EDGE_COUNT) : std::string()) + ">";
         }
         
     }; // class Sampler
@@ -0,0 +1,150 @@
+private:
+
+    // Per-thread accumulators for the sampling routines that reduce over all samples (BinnedSample, ConfidenceSample).
+    //
+    // Each thread owns one row of an AccumulatorArray and adds to it without any synchronization. The rows are padded to whole cache lines and start at cache line boundaries, so that no two threads ever write to the same cache line.
+    //
+    // After the parallel loop, ReduceTo sums the rows by a pairwise tree of fixed shape: on level l, row i + 2^l is added to row i for all i divisible by 2^(l+1). This needs no locks, it is parallelized over the entries, and the rounding errors do not depend on the timing of the threads.
+
+    class AccumulatorArray
+    {
+    private:
+
+        static constexpr Int CacheLineWidth = 64;
+
+        static constexpr Int line = std::max( Int(1), Int(CacheLineWidth / static_cast<Int>(sizeof(Real))) );
+
+        Int row_count = 0;
+        Int size      = 0;
+        Int stride    = 0;
+
+        Tensor1<Real,Int> buffer;
+
+        mptr<Real> a = nullptr;
+
+    public:
+
+        AccumulatorArray( const Int row_count_, const Int size_ )
+        :   row_count ( std::max( Int(1), row_count_ ) )
+        ,   size      ( std::max( Int(0), size_ ) )
+        ,   stride    ( line * ( (size + line - 1) / line ) )
+        ,   buffer    ( row_count * stride + line )
+        {
+            // Align the first row to a cache line.
+            const std::uintptr_t address = reinterpret_cast<std::uintptr_t>( buffer.data() );
+
+            const std::uintptr_t misalignment = address % static_cast<std::uintptr_t>(CacheLineWidth);
+
+            const Int offset = (misalignment == 0)
+                ? Int(0)
+                : static_cast<Int>( (CacheLineWidth - misalignment) / sizeof(Real) );
+
+            a = buffer.data() + offset;
+
+            buffer.SetZero();
+        }
+
+        Int Size() const
+        {
+            return size;
+        }
+
+        Real * operator[]( const Int thread )
+        {
+            return &a[stride * thread];
+        }
+
+        void SetZero( const Int thread )
+        {
+            zerofy_buffer<VarSize,Sequential>( (*this)[thread], size );
+        }
+
+        // Sums all rows and adds the result to target, using thread_count threads.
+        void ReduceTo( mptr<Real> target, const Int thread_count )
+        {
+            // There is no point in waking up threads for a few cache lines.
+            const Int job_count = ( size * row_count < Int(1) << 16 )
+                ? Int(1)
+                : std::max( Int(1), std::min( thread_count, size / line ) );
+
+            ParallelDo(
+                [=,this]( const Int job )
+                {
+                    // Split at cache line boundaries, so that the jobs do not share cache lines.
+                    const Int begin = std::min( size, line * JobPointer( stride / line, job_count, job     ) );
+                    const Int end   = std::min( size, line * JobPointer( stride / line, job_count, job + 1 ) );
+
+                    for( Int step = 1; step < row_count; step *= 2 )
+                    {
+                        for( Int i = 0; i + step < row_count; i += 2 * step )
+                        {
+                            mptr<Real> x = &a[stride * i         ];
+                            cptr<Real> y = &a[stride * (i + step)];
+
+                            for( Int j = begin; j < end; ++j )
+                            {
+                                x[j] += y[j];
+                            }
+                        }
+                    }
+
+                    for( Int j = begin; j < end; ++j )
+                    {
+                        target[j] += a[j];
+                    }
+                },
+                job_count
+            );
+        }
+    };
+
+    // Sparse per-thread histogram for BinnedSample with many bins (Settings().use_sparse_bins). Stores only the bins that are actually hit; the keys are i * bin_count + bin_idx.
+
+    using SparseBins_T = std::unordered_map<Int,std::array<Real,3>>;
+
+    using SparseBinList_T = std::vector<std::pair<Int,std::array<Real,3>>>;
+
+    // Adds the sorted sparse histograms lists[0], ..., lists[thread_count-1] to the dense array bins of size 3 x key_count. The range of keys is split among the threads, so no two threads write to the same entry; each entry receives its contributions in the order of the lists.
+
+    static void ReduceSparseBins(
+        const std::vector<SparseBinList_T> & lists,
+        mptr<Real> bins, const Int key_count, const Int thread_count
+    )
+    {
+        Size_T entry_count = 0;
+
+        for( const auto & list : lists )
+        {
+            entry_count += list.size();
+        }
+
+        const Int job_count = ( entry_count < (Size_T(1) << 16) )
+            ? Int(1)
+            : std::max( Int(1), thread_count );
+
+        ParallelDo(
+            [&]( const Int job )
+            {
+                const Int begin = JobPointer( key_count, job_count, job     );
+                const Int end   = JobPointer( key_count, job_count, job + 1 );
+
+                for( const auto & list : lists )
+                {
+                    auto iter = std::lower_bound(
+                        list.begin(), list.end(), begin,
+                        []( const auto & entry, const Int key ) { return entry.first < key; }
+                    );
+
+                    for( ; (iter != list.end()) && (iter->first < end); ++iter )
+                    {
+                        const Int key = iter->first;
+
+                        bins[key                ] += iter->second[0];
+                        bins[key +     key_count] += iter->second[1];
+                        bins[key + 2 * key_count] += iter->second[2];
+                    }
+                }
+            },
+            job_count
+        );
+    }
@@ -15,6 +15,8 @@ public:
         
         // ranges: Specify the range for binning: For j-th function in F_list, the range from ranges(j,0) to ranges(j,1) will be divided into bin_count bins. The user is supposed to provide meaningful ranges. Some rough guess might be obtained by calling the random variables on the prepared Sampler S.
         
+        // For very many bins, set Settings().use_sparse_bins. Then each thread only stores the bins that it actually hits instead of a full copy of bins.
+        
         ptic(ClassName()+"::BinnedSample");
         
         const Int f_count = static_cast<Int>(F_list.size());
@@ -43,81 +45,335 @@ public:
             print("    " + F_list[i_]->Tag());
         }
 
+        const Int bin_size = f_count * b_count;
+        const Int mom_size = f_count * m_count;
+        
+        const bool sparseQ = Settings().use_sparse_bins;
+        
+        AccumulatorArray bins_acc ( thread_count, sparseQ ? Int(0) : 3 * bin_size );
+        AccumulatorArray moms_acc ( thread_count, 3 * mom_size );
+        
+        std::vector<SparseBinList_T> sparse_bins ( sparseQ ? static_cast<Size_T>(thread_count) : Size_T(0) );
+        
+        WorkerSet workers = PrepareWorkers( thread_count );
+        
+        accumulateBinnedSample(
+            F_list, factor.data(), ranges, b_count, m_count, 0, sample_count, thread_count, workers,
+            bins_acc, moms_acc, sparse_bins, bins, moms
+        );
+        
+        ptoc(ClassName()+"::BinnedSample");
+    }
+
+
+    /*!
+     * @brief Like `BinnedSample`, but samples in chunks of `chunk_size` samples and writes a checkpoint to `checkpoint_file` after every `checkpoint_interval` chunks and at the end. If `checkpoint_file` already exists, the run is resumed from there.
+     *
+     * A checkpoint contains the histograms and moments accumulated so far, the number of samples done, the elapsed time, and the states of the pseudorandom number generators of all threads. It is replaced atomically, so a killed run can always be resumed from its last checkpoint by calling this routine again with the same arguments and settings. The result is then the same bit for bit as that of an uninterrupted run, provided that the samples are assigned to the threads deterministically, i.e., `Settings().use_seed` is set or `Settings().use_dynamic_scheduling` is not set.
+     *
+     * `sample_count` may be larger than in the run that wrote the checkpoint; then the run is extended.
+     *
+     * @return The number of samples whose histograms and moments were added to `bins` and `moms`, or 0 if `checkpoint_file` does not belong to this run.
+     */
+
+    Int ResumableBinnedSample(
+        const std::string & checkpoint_file,
+        const Int checkpoint_interval,
+              Real * restrict const bins,   const Int bin_count,
+              Real * restrict const moms,   const Int mom_count,
+        const Real * restrict const ranges,
+        const std::vector< std::shared_ptr<RandomVariable_T> > & F_list,
+        const Int sample_count,
+        const Int thread_count = 1,
+        const Int chunk_size = 1000000
+    ) const
+    {
+        ptic(ClassName()+"::ResumableBinnedSample");
+        
+        const Int f_count = static_cast<Int>(F_list.size());
+        
+        const Int m_count = std::max( static_cast<Int>(3), mom_count );
+        
+        const Int b_count = std::max( bin_count, static_cast<Int>(1) );
+        
+        const Int chunk    = std::max( chunk_size,          static_cast<Int>(1) );
+        const Int interval = std::max( checkpoint_interval, static_cast<Int>(1) );
+        
+        if( Settings().use_qmc && !Settings().use_seed )
+        {
+            eprint(ClassName()+"::ResumableBinnedSample: Checkpoints in randomized quasi-Monte Carlo mode require Settings().use_seed. Aborting." );
+            
+            ptoc(ClassName()+"::ResumableBinnedSample");
+            
+            return 0;
+        }
+        
+        valprint( "dimension   ", AmbDim       );
+        valprint( "edge_count  ", edge_count_  );
+        valprint( "sample_count", sample_count );
+        valprint( "fun_count   ", f_count      );
+        valprint( "bin_count   ", b_count      );
+        valprint( "moment_count", m_count      );
+        valprint( "thread_count", thread_count );
+        valprint( "chunk_size  ", chunk        );
+        
+        Tensor1<Real,Int> factor ( f_count );
+        
+        print("Sampling (binned) the following random variables:");
+        for( Int i = 0; i < f_count; ++ i )
+        {
+            const Size_T i_ = static_cast<Size_T>(i);
+            factor(i) = static_cast<Real>(bin_count) / ( ranges[2*i+1] - ranges[2*i+0] );
+
+            print("    " + F_list[i_]->Tag());
+        }
+        
+        const Int bin_size = f_count * b_count;
+        const Int mom_size = f_count * m_count;
+        
+        CheckpointWriter header = CheckpointHeader(
+            CheckpointKind::BinnedSample, RandomVariableTags( F_list ), thread_count, chunk
+        );
+        
+        header.Put( b_count );
+        header.Put( m_count );
+        header.PutArray( ranges, static_cast<Size_T>(2 * f_count) );
+        
+        Tensor1<Real,Int> bins_total ( 3 * bin_size, zero );
+        Tensor1<Real,Int> moms_total ( 3 * mom_size, zero );
+        
+        Int k_done = 0;
+        
+        Real total_time = 0;
+        
+        WorkerSet workers = PrepareWorkers( thread_count );
+        
+        if( CheckpointExistsQ( checkpoint_file ) )
+        {
+            CheckpointReader r;
+            
+            std::uint64_t k = 0;
+            
+            const bool okQ = r.Load( checkpoint_file )
+                && r.Expect( header.Data() )
+                && r.Get( k )
+                && r.Get( total_time )
+                && r.GetArray( bins_total.data(), static_cast<Size_T>(bins_total.Size()) )
+                && r.GetArray( moms_total.data(), static_cast<Size_T>(moms_total.Size()) )
+                && GetRandomEngines( r, workers, thread_count )
+                && r.AtEndQ();
+            
+            if( !okQ )
+            {
+                eprint(ClassName()+"::ResumableBinnedSample: File " + checkpoint_file + " is not a checkpoint of this run. Aborting.");
+                
+                ptoc(ClassName()+"::ResumableBinnedSample");
+                
+                return 0;
+            }
+            
+            k_done = static_cast<Int>(k);
+            
+            print("Resuming from checkpoint " + checkpoint_file + " after " + ToString(k_done) + " samples.");
+        }
+        
+        const bool sparseQ = Settings().use_sparse_bins;
+        
+        AccumulatorArray bins_acc ( thread_count, sparseQ ? Int(0) : 3 * bin_size );
+        AccumulatorArray moms_acc ( thread_count, 3 * mom_size );
+        
+        std::vector<SparseBinList_T> sparse_bins ( sparseQ ? static_cast<Size_T>(thread_count) : Size_T(0) );
+        
+        auto write_checkpoint = [&,this]()
+        {
+            CheckpointWriter w = header;
+            
+            w.Put( static_cast<std::uint64_t>(k_done) );
+            w.Put( total_time );
+            w.PutArray( bins_total.data(), static_cast<Size_T>(bins_total.Size()) );
+            w.PutArray( moms_total.data(), static_cast<Size_T>(moms_total.Size()) );
+            
+            PutRandomEngines( w, workers, thread_count );
+            
+            if( !w.Commit( checkpoint_file ) )
+            {
+                wprint(ClassName()+"::ResumableBinnedSample: Could not write checkpoint file " + checkpoint_file + ".");
+            }
+        };
+        
+        Int unsaved_chunk_count = 0;
+        
+        while( k_done < sample_count )
+        {
+            Time start_time = Clock::now();
+            
+            const Int k_end = std::min( sample_count, k_done + chunk );
+            
+            accumulateBinnedSample(
+                F_list, factor.data(), ranges, b_count, m_count, k_done, k_end, thread_count, workers,
+                bins_acc, moms_acc, sparse_bins, bins_total.data(), moms_total.data()
+            );
+            
+            Time stop_time = Clock::now();
+            
+            total_time += Tools::Duration(start_time,stop_time);
+            
+            k_done = k_end;
+            
+            if( ++unsaved_chunk_count >= interval )
+            {
+                write_checkpoint();
+                
+                unsaved_chunk_count = 0;
+            }
+        }
+        
+        if( unsaved_chunk_count > 0 )
+        {
+            write_checkpoint();
+        }
+        
+        valprint( "total_time  ", total_time );
+        
+        for( Int j = 0; j < 3 * bin_size; ++j )
+        {
+            bins[j] += bins_total[j];
+        }
+        
+        for( Int j = 0; j < 3 * mom_size; ++j )
+        {
+            moms[j] += moms_total[j];
+        }
+        
+        ptoc(ClassName()+"::ResumableBinnedSample");
+        
+        return k_done;
+    }
+
+
+private:
+
+    // Samples [k_begin,k_end) with thread_count threads (the samplers in workers) and adds the histograms and moments to bins and moms. The accumulators are overwritten; they must have one row (or list) per thread.
+
+    void accumulateBinnedSample(
+        const std::vector< std::shared_ptr<RandomVariable_T> > & F_list,
+        cptr<Real> factor,
+        cptr<Real> ranges,
+        const Int b_count,
+        const Int m_count,
+        const Int k_begin,
+        const Int k_end,
+        const Int thread_count,
+        WorkerSet & workers,
+        AccumulatorArray & bins_acc,
+        AccumulatorArray & moms_acc,
+        std::vector<SparseBinList_T> & sparse_bins,
+        mptr<Real> bins,
+        mptr<Real> moms
+    ) const
+    {
+        const Int f_count = static_cast<Int>(F_list.size());
+        
         const Int lower = static_cast<Int>(0);
-        const Int upper = static_cast<Int>(bin_count-1);
+        const Int upper = static_cast<Int>(b_count-1);
         
+        const Int bin_size = f_count * b_count;
+        const Int mom_size = f_count * m_count;
         
-        std::mutex mutex;
+        const bool sparseQ = Settings().use_sparse_bins;
+        
+        // Each thread accumulates into its own cache-line aligned row; the rows are summed up after sampling. In sparse mode, the bins of each thread are kept in a hash map instead.
+        
+        SampleScheduler scheduler ( Settings(), k_begin, k_end, thread_count );
         
         ParallelDo(
             [&,this]( const Int thread )
             {
                 Time start = Clock::now();
                 
-                const Int k_begin = JobPointer( sample_count, thread_count, thread     );
-                const Int k_end   = JobPointer( sample_count, thread_count, thread + 1 );
+                Sampler & S = workers[thread];
                 
-                const Int repetitions = k_end - k_begin;
+                RandomStreamCursor cursor = RandomStream();
                 
-                Sampler S ( EdgeLengths().data(), Rho().data(), EdgeCount(), Settings() );
-                
-                S.LoadRandomVariables( F_list );
+                S.LoadRandomVariablesCached( F_list );
 
-                Tensor3<Real,Int> bins_local( 3, f_count, b_count, zero );
-                Tensor3<Real,Int> moms_local( 3, f_count, m_count, zero );
+                bins_acc.SetZero( thread );
+                moms_acc.SetZero( thread );
 
-                for( Int k = 0; k < repetitions; ++k )
-                {
-                    S.RandomizeInitialEdgeVectors();
+                mptr<Real> bins_local = bins_acc[thread];
+                mptr<Real> moms_local = moms_acc[thread];
+                
+                SparseBins_T bins_map;
 
-                    S.ComputeConformalClosure();
-                    
-                    const Real K = S.EdgeSpaceSamplingWeight();
+                scheduler.Work( thread, [&]( const Int a, const Int b )
+                {
+                    ClosedPolygonLoop<true,true>( S, cursor, a, b,
+                        [&]( const Int k )
+                        {
+                            (void)k;
+                            
+                            const Real K = S.EdgeSpaceSamplingWeight();
 
-                    const Real K_quot = S.EdgeQuotientSpaceSamplingWeight();
+                            const Real K_quot = S.EdgeQuotientSpaceSamplingWeight();
 
-                    for( Int i = 0; i < f_count; ++i )
-                    {
-                        const Real val = S.EvaluateRandomVariable(i);
+                            for( Int i = 0; i < f_count; ++i )
+                            {
+                                const Real val = S.EvaluateRandomVariable(i);
 
-                        Real values [3] = { one, K, K_quot };
+                                Real values [3] = { one, K, K_quot };
 
-                        const Int bin_idx = static_cast<Int>(
-                            std::floor( factor[i] * (val - ranges[2*i]) )
-                        );
+                                const Int bin_idx = static_cast<Int>(
+                                    std::floor( factor[i] * (val - ranges[2*i]) )
+                                );
 
-                        if( (bin_idx <= upper) && (bin_idx >= lower) )
-                        {
-                            bins_local(0,i,bin_idx) += one;
-                            bins_local(1,i,bin_idx) += K;
-                            bins_local(2,i,bin_idx) += K_quot;
-                        }
+                                if( (bin_idx <= upper) && (bin_idx >= lower) )
+                                {
+                                    const Int key = b_count * i + bin_idx;
+                                    
+                                    if( sparseQ )
+                                    {
+                                        std::array<Real,3> & entry = bins_map[key];
+                                        
+                                        entry[0] += one;
+                                        entry[1] += K;
+                                        entry[2] += K_quot;
+                                    }
+                                    else
+                                    {
+                                        bins_local[key               ] += one;
+                                        bins_local[key +     bin_size] += K;
+                                        bins_local[key + 2 * bin_size] += K_quot;
+                                    }
+                                }
 
-                        moms_local(0,i,0) += values[0];
-                        moms_local(1,i,0) += values[1];
-                        moms_local(2,i,0) += values[2];
+                                mptr<Real> m = &moms_local[m_count * i];
+                                
+                                m[0           ] += values[0];
+                                m[    mom_size] += values[1];
+                                m[2 * mom_size] += values[2];
 
-                        for( Int j = 1; j < m_count; ++j )
-                        {
-                            values[0] *= val;
-                            values[1] *= val;
-                            values[2] *= val;
-                            moms_local(0,i,j) += values[0];
-                            moms_local(1,i,j) += values[1];
-                            moms_local(2,i,j) += values[2];
+                                for( Int j = 1; j < m_count; ++j )
+                                {
+                                    values[0] *= val;
+                                    values[1] *= val;
+                                    values[2] *= val;
+                                    m[j             ] += values[0];
+                                    m[j +   mom_size] += values[1];
+                                    m[j + 2*mom_size] += values[2];
+                                }
+                            }
                         }
-                    }
-                }
+                    );
+                });
                 
+                if( sparseQ )
                 {
-                    const std::lock_guard<std::mutex> lock ( mutex );
+                    SparseBinList_T & list = sparse_bins[static_cast<Size_T>(thread)];
                     
-                    add_to_buffer<VarSize,Sequential>(
-                        bins_local.data(), bins, 3 * f_count * b_count
-                    );
+                    list.assign( bins_map.begin(), bins_map.end() );
                     
-                    add_to_buffer<VarSize,Sequential>(
-                        moms_local.data(), moms, 3 * f_count * m_count
+                    std::sort( list.begin(), list.end(),
+                        []( const auto & x, const auto & y ) { return x.first < y.first; }
                     );
                 }
                 
@@ -129,6 +385,14 @@ public:
             thread_count
         );
         
-        ptoc(ClassName()+"::BinnedSample");
+        if( sparseQ )
+        {
+            ReduceSparseBins( sparse_bins, bins, bin_size, thread_count );
+        }
+        else
+        {
+            bins_acc.ReduceTo( bins, thread_count );
+        }
+        
+        moms_acc.ReduceTo( moms, thread_count );
     }
-
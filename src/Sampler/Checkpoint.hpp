@@ -0,0 +1,268 @@
+private:
+
+    // Checkpoints of ResumableConfidenceSample and ResumableBinnedSample.
+    //
+    // A checkpoint is a binary file (native byte order) that contains a header identifying the run, the accumulators, the total time, and the states of the pseudorandom number generators of all worker threads (and of their BatchSamplers). The states are stored as raw bytes, so a checkpoint can only be resumed by a program that was compiled with the same pseudorandom number generator and compiler.
+    //
+    // A checkpoint is written to path + ".tmp" first, flushed to disk, and then renamed to path. So path always contains a complete checkpoint, even if the process is killed while writing.
+
+    static constexpr std::uint64_t CheckpointMagic   = 0x54504B43534142; // "BASCKPT"
+    static constexpr std::uint64_t CheckpointVersion = 2;
+
+    enum class CheckpointKind : std::uint64_t
+    {
+        ConfidenceSample = 1,
+        BinnedSample     = 2
+    };
+
+    class CheckpointWriter
+    {
+    private:
+
+        std::string data;
+
+    public:
+
+        template<typename T>
+        void Put( const T & x )
+        {
+            static_assert( std::is_trivially_copyable_v<T>, "" );
+
+            data.append( reinterpret_cast<const char *>(&x), sizeof(T) );
+        }
+
+        void PutString( const std::string & s )
+        {
+            Put( static_cast<std::uint64_t>(s.size()) );
+
+            data.append( s );
+        }
+
+        template<typename T>
+        void PutArray( const T * a, const Size_T count )
+        {
+            Put( static_cast<std::uint64_t>(count) );
+
+            data.append( reinterpret_cast<const char *>(a), sizeof(T) * count );
+        }
+
+        const std::string & Data() const
+        {
+            return data;
+        }
+
+        bool Commit( const std::string & path ) const
+        {
+            const std::string tmp_path = path + ".tmp";
+
+#ifdef COBARS_POSIX
+            const int fd = ::open( tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+
+            if( fd < 0 )
+            {
+                return false;
+            }
+
+            bool succeededQ = WriteAll( fd, data.data(), data.size() ) && (::fsync( fd ) == 0);
+
+            succeededQ = (::close( fd ) == 0) && succeededQ;
+#else
+            // Without POSIX, there is neither fsync nor an atomic replacement of path; so a crash at the wrong moment may lose the checkpoint.
+            std::ofstream file ( tmp_path, std::ios::binary | std::ios::trunc );
+
+            file.write( data.data(), static_cast<std::streamsize>(data.size()) );
+
+            file.close();
+
+            const bool succeededQ = !file.fail();
+
+            // std::rename does not replace an existing file on every system.
+            if( succeededQ )
+            {
+                (void)std::remove( path.c_str() );
+            }
+#endif
+
+            return succeededQ && (std::rename( tmp_path.c_str(), path.c_str() ) == 0);
+        }
+    };
+
+    class CheckpointReader
+    {
+    private:
+
+        std::string data;
+
+        Size_T pos = 0;
+
+    public:
+
+        bool Load( const std::string & path )
+        {
+            std::ifstream file ( path, std::ios::binary );
+
+            if( !file )
+            {
+                return false;
+            }
+
+            data.assign( std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() );
+
+            pos = 0;
+
+            return true;
+        }
+
+        template<typename T>
+        bool Get( T & x )
+        {
+            static_assert( std::is_trivially_copyable_v<T>, "" );
+
+            if( pos + sizeof(T) > data.size() )
+            {
+                return false;
+            }
+
+            std::memcpy( &x, data.data() + pos, sizeof(T) );
+
+            pos += sizeof(T);
+
+            return true;
+        }
+
+        bool GetString( std::string & s )
+        {
+            std::uint64_t size = 0;
+
+            if( !Get( size ) || (pos + size > data.size()) )
+            {
+                return false;
+            }
+
+            s = data.substr( pos, static_cast<Size_T>(size) );
+
+            pos += static_cast<Size_T>(size);
+
+            return true;
+        }
+
+        // Reads an array that must have exactly count entries.
+        template<typename T>
+        bool GetArray( T * a, const Size_T count )
+        {
+            std::uint64_t size = 0;
+
+            if( !Get( size ) || (size != count) || (pos + sizeof(T) * count > data.size()) )
+            {
+                return false;
+            }
+
+            std::memcpy( a, data.data() + pos, sizeof(T) * count );
+
+            pos += sizeof(T) * count;
+
+            return true;
+        }
+
+        // Reads bytes.size() bytes and compares them with bytes.
+        bool Expect( const std::string & bytes )
+        {
+            if( (pos + bytes.size() > data.size()) || (data.compare( pos, bytes.size(), bytes ) != 0) )
+            {
+                return false;
+            }
+
+            pos += bytes.size();
+
+            return true;
+        }
+
+        bool AtEndQ() const
+        {
+            return pos == data.size();
+        }
+    };
+
+    // Everything that must agree between the run that wrote a checkpoint and the run that resumes it. The caller may append further parameters; a checkpoint is accepted if it starts with the same bytes.
+    CheckpointWriter CheckpointHeader(
+        const CheckpointKind kind,
+        const std::vector<std::string> & tags, const Int thread_count, const Int chunk_size
+    ) const
+    {
+        CheckpointWriter w;
+
+        w.Put( CheckpointMagic );
+        w.Put( CheckpointVersion );
+        w.Put( kind );
+        w.Put( static_cast<std::uint64_t>(AmbDim) );
+        w.Put( static_cast<std::uint64_t>(sizeof(Real)) );
+        w.Put( static_cast<std::uint64_t>(edge_count_) );
+        w.PutArray( r_.data(),   static_cast<Size_T>(edge_count_) );
+        w.PutArray( rho_.data(), static_cast<Size_T>(edge_count_) );
+        w.PutString( PRNG_Name() );
+        w.Put( static_cast<std::uint64_t>(sizeof(Prng_T)) );
+        w.Put( static_cast<std::uint64_t>(Settings().use_seed) );
+        w.Put( static_cast<std::uint64_t>(Settings().seed) );
+        w.Put( static_cast<std::uint64_t>(Settings().samples_per_stream) );
+        w.Put( static_cast<std::uint64_t>(Settings().use_batch_engine) );
+        w.Put( static_cast<std::uint64_t>(Settings().use_qmc) );
+        w.Put( static_cast<std::uint64_t>(Settings().use_qmc ? Settings().qmc_replicate_count : 0) );
+        w.Put( static_cast<std::uint64_t>(thread_count) );
+        w.Put( static_cast<std::uint64_t>(chunk_size) );
+        w.Put( static_cast<std::uint64_t>(tags.size()) );
+
+        for( const std::string & tag : tags )
+        {
+            w.PutString( tag );
+        }
+
+        return w;
+    }
+
+    static bool CheckpointExistsQ( const std::string & path )
+    {
+#ifdef COBARS_POSIX
+        return ::access( path.c_str(), F_OK ) == 0;
+#else
+        return std::ifstream( path ).good();
+#endif
+    }
+
+    // The states of the pseudorandom number generators of the worker threads.
+
+    void PutRandomEngines( CheckpointWriter & w, WorkerSet & workers, const Int thread_count ) const
+    {
+        static_assert( std::is_trivially_copyable_v<Prng_T>, "" );
+
+        for( Int thread = 0; thread < thread_count; ++thread )
+        {
+            Sampler & S = workers[thread];
+
+            w.Put( S.random_engine );
+
+            if( Settings().use_batch_engine )
+            {
+                w.Put( S.BatchEngine().RandomEngine() );
+            }
+        }
+    }
+
+    bool GetRandomEngines( CheckpointReader & r, WorkerSet & workers, const Int thread_count ) const
+    {
+        for( Int thread = 0; thread < thread_count; ++thread )
+        {
+            Sampler & S = workers[thread];
+
+            if( !r.Get( S.random_engine ) )
+            {
+                return false;
+            }
+
+            if( Settings().use_batch_engine && !r.Get( S.BatchEngine().RandomEngine() ) )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
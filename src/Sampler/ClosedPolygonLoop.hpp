@@ -0,0 +1,85 @@
+private:
+
+    // Common loop of
+    //
+    // - CreatePolygons (random input only),
+    // - sample_2,
+    // - BinnedSample,
+    // - ConfidenceSample.
+    //
+    // For each k in [k_begin,k_end) it generates a random open polygon, computes its conformal closure in S, and then calls body(k).
+    // If Settings().use_batch_engine is set (and Settings().solver_strategy is SolverStrategy::Newton, the only one that BatchSampler implements), then the polygons are closed in groups of BatchLanes by a BatchSampler and loaded into S one after another.
+    // k is the global index of the sample; in reproducible mode (Settings().use_seed) it determines the random numbers; see RandomStreamCursor. The caller keeps one cursor per thread for all its chunks.
+    // In randomized quasi-Monte Carlo mode (Settings().use_qmc), the open polygon of sample k is computed from the RQMC sample k of S.qmc_ instead (see WorkerSet).
+    //
+    // This function is meant to be called only from there.
+
+    template<bool vertex_pos_Q, bool quot_space_Q, typename Body_T>
+    void ClosedPolygonLoop(
+        Sampler & S, RandomStreamCursor & cursor, const Int k_begin, const Int k_end, Body_T && body
+    ) const
+    {
+        const ScrambledSobol * qmc = Settings().use_qmc ? S.qmc_.get() : nullptr;
+        
+        if( Settings().use_batch_engine && (Settings().solver_strategy == SolverStrategy::Newton) )
+        {
+            constexpr Int lanes = static_cast<Int>(BatchLanes);
+
+            BatchSampler_T & B = S.BatchEngine();
+
+            Int k = k_begin;
+            
+            while( k < k_end )
+            {
+                Int lane_count = std::min( lanes, k_end - k );
+                
+                if( cursor.ActiveQ() && (qmc == nullptr) )
+                {
+                    // A group of lanes must not cross the boundary of a stream.
+                    lane_count = std::min( lane_count, cursor.RemainingInStream(k) );
+                }
+                
+                if( qmc != nullptr )
+                {
+                    B.QuasiRandomizeInitialEdgeVectors( *qmc, k, lane_count );
+                }
+                else
+                {
+                    cursor.Seek( B.RandomEngine(), k, lane_count );
+
+                    B.RandomizeInitialEdgeVectors( lane_count );
+                }
+
+                B.ComputeConformalClosures();
+
+                for( Int l = 0; l < lane_count; ++l )
+                {
+                    B.template LoadLane<vertex_pos_Q,quot_space_Q>( l, S );
+
+                    body( k + l );
+                }
+                
+                k += lane_count;
+            }
+        }
+        else
+        {
+            for( Int k = k_begin; k < k_end; ++k )
+            {
+                if( qmc != nullptr )
+                {
+                    S.QuasiRandomizeInitialEdgeVectors( *qmc, k );
+                }
+                else
+                {
+                    cursor.Seek( S.random_engine, k );
+                    
+                    S.RandomizeInitialEdgeVectors();
+                }
+
+                S.template computeConformalClosure<vertex_pos_Q,quot_space_Q>();
+
+                body( k );
+            }
+        }
+    }
@@ -0,0 +1,239 @@
+public:
+
+    /*!
+     * @brief Like `CreateRandomClosedPolygons`, but stores the vertex positions and the sampling weights as `float`. All computations are still done in `Real`.
+     *
+     * @param q Target array of size at least `sample_count * (n + 1) * d`; same layout as for `CreateRandomClosedPolygons`.
+     *
+     * @param K Target array for the sampling weights of size at least `sample_count`.
+     */
+
+    void CreateRandomClosedPolygons_Float32(
+        float * restrict const q,
+        float * restrict const K,
+        const Int sample_count,
+        const bool quotient_space_Q = true,
+        const Int thread_count = 1
+    ) const
+    {
+        ptic(ClassName()+"::CreateRandomClosedPolygons_Float32");
+
+        const Int size = (edge_count_ + 1) * AmbDim;
+
+        auto write = [=]( Sampler & S, mptr<Real> buffer, const Int k, const Real K_k )
+        {
+            S.WriteVertexPositions( buffer );
+
+            ConvertToFloat32( buffer, &q[size * k], size );
+
+            K[k] = static_cast<float>(K_k);
+        };
+
+        if( quotient_space_Q )
+        {
+            CreateCompact<true,true>( sample_count, thread_count,
+                [=]( Sampler & S, mptr<Real> buffer, const Int k )
+                {
+                    write( S, buffer, k, S.OutputEdgeQuotientSpaceSamplingWeight() );
+                }
+            );
+        }
+        else
+        {
+            CreateCompact<true,false>( sample_count, thread_count,
+                [=]( Sampler & S, mptr<Real> buffer, const Int k )
+                {
+                    write( S, buffer, k, S.OutputEdgeSpaceSamplingWeight() );
+                }
+            );
+        }
+
+        ptoc(ClassName()+"::CreateRandomClosedPolygons_Float32");
+    }
+
+    /*!
+     * @brief Like `CreateRandomClosedPolygons`, but stores only the unit edge vectors of the closed polygons, in octahedral encoding with 2 x 16 bits per edge (see `CoBarS::OctahedralEncode`), and the sampling weights as `float`. That is 12 times less memory than `Real = double` vertex positions. Use `CoBarS::OctahedralDecodePolygons` to reconstruct the vertex positions. Only for `AmbDim == 3`.
+     *
+     * @param y_code Target array of size at least `sample_count * n * 2`. The code of the `i`-th unit edge vector of the `k`-th polygon is stored in `y_code[2 * n * k + 2 * i]` and `y_code[2 * n * k + 2 * i + 1]`.
+     *
+     * @param K Target array for the sampling weights of size at least `sample_count`.
+     */
+
+    void CreateRandomClosedPolygons_Octahedral(
+        std::uint16_t * restrict const y_code,
+        float         * restrict const K,
+        const Int sample_count,
+        const bool quotient_space_Q = true,
+        const Int thread_count = 1
+    ) const
+    {
+        static_assert( AmbDim == 3, "Octahedral encoding is only available for AmbDim == 3." );
+
+        ptic(ClassName()+"::CreateRandomClosedPolygons_Octahedral");
+
+        const Int n = edge_count_;
+
+        auto write = [=]( Sampler & S, mptr<Real> buffer, const Int k, const Real K_k )
+        {
+            S.WriteEdgeVectors( buffer );
+
+            OctahedralEncodeVectors( buffer, &y_code[2 * n * k], n );
+
+            K[k] = static_cast<float>(K_k);
+        };
+
+        if( quotient_space_Q )
+        {
+            CreateCompact<false,true>( sample_count, thread_count,
+                [=]( Sampler & S, mptr<Real> buffer, const Int k )
+                {
+                    write( S, buffer, k, S.OutputEdgeQuotientSpaceSamplingWeight() );
+                }
+            );
+        }
+        else
+        {
+            CreateCompact<false,false>( sample_count, thread_count,
+                [=]( Sampler & S, mptr<Real> buffer, const Int k )
+                {
+                    write( S, buffer, k, S.OutputEdgeSpaceSamplingWeight() );
+                }
+            );
+        }
+
+        ptoc(ClassName()+"::CreateRandomClosedPolygons_Octahedral");
+    }
+
+    /*!
+     * @brief Like `CreateRandomCentralizedPointClouds_Detailed`, but stores all outputs as `float`. All computations are still done in `Real`. The arrays have the same sizes and layouts as for `CreateRandomCentralizedPointClouds_Detailed`.
+     */
+
+    void CreateRandomCentralizedPointClouds_Detailed_Float32(
+        float * restrict const x,
+        float * restrict const w,
+        float * restrict const y,
+        float * restrict const K_edge_space,
+        float * restrict const K_quot_space,
+        const Int sample_count,
+        const Int thread_count = 1
+    ) const
+    {
+        ptic(ClassName()+"::CreateRandomCentralizedPointClouds_Detailed_Float32");
+
+        const Int size = edge_count_ * AmbDim;
+
+        CreateCompact<false,true>( sample_count, thread_count,
+            [=]( Sampler & S, mptr<Real> buffer, const Int k )
+            {
+                S.WriteInitialEdgeVectors( buffer );
+
+                ConvertToFloat32( buffer, &x[size * k], size );
+
+                S.WriteEdgeVectors( buffer );
+
+                ConvertToFloat32( buffer, &y[size * k], size );
+
+                S.WriteShiftVector( buffer );
+
+                ConvertToFloat32( buffer, &w[AmbDim * k], Int(AmbDim) );
+
+                K_edge_space[k] = static_cast<float>( S.OutputEdgeSpaceSamplingWeight() );
+                K_quot_space[k] = static_cast<float>( S.OutputEdgeQuotientSpaceSamplingWeight() );
+            }
+        );
+
+        ptoc(ClassName()+"::CreateRandomCentralizedPointClouds_Detailed_Float32");
+    }
+
+    /*!
+     * @brief Like `CreateRandomCentralizedPointClouds_Detailed`, but stores the unit vectors `x` and `y` in octahedral encoding with 2 x 16 bits per vector (see `CoBarS::OctahedralEncode`), and the shift vectors `w` and the sampling weights as `float`. Use `CoBarS::OctahedralDecodeVectors` to decode `x_code` and `y_code`. Only for `AmbDim == 3`.
+     *
+     * @param x_code Target array of size at least `sample_count * n * 2`.
+     *
+     * @param w Target array of size at least `sample_count * d`.
+     *
+     * @param y_code Target array of size at least `sample_count * n * 2`.
+     */
+
+    void CreateRandomCentralizedPointClouds_Detailed_Octahedral(
+        std::uint16_t * restrict const x_code,
+        float         * restrict const w,
+        std::uint16_t * restrict const y_code,
+        float         * restrict const K_edge_space,
+        float         * restrict const K_quot_space,
+        const Int sample_count,
+        const Int thread_count = 1
+    ) const
+    {
+        static_assert( AmbDim == 3, "Octahedral encoding is only available for AmbDim == 3." );
+
+        ptic(ClassName()+"::CreateRandomCentralizedPointClouds_Detailed_Octahedral");
+
+        const Int n = edge_count_;
+
+        CreateCompact<false,true>( sample_count, thread_count,
+            [=]( Sampler & S, mptr<Real> buffer, const Int k )
+            {
+                S.WriteInitialEdgeVectors( buffer );
+
+                OctahedralEncodeVectors( buffer, &x_code[2 * n * k], n );
+
+                S.WriteEdgeVectors( buffer );
+
+                OctahedralEncodeVectors( buffer, &y_code[2 * n * k], n );
+
+                S.WriteShiftVector( buffer );
+
+                ConvertToFloat32( buffer, &w[AmbDim * k], Int(AmbDim) );
+
+                K_edge_space[k] = static_cast<float>( S.OutputEdgeSpaceSamplingWeight() );
+                K_quot_space[k] = static_cast<float>( S.OutputEdgeQuotientSpaceSamplingWeight() );
+            }
+        );
+
+        ptoc(ClassName()+"::CreateRandomCentralizedPointClouds_Detailed_Octahedral");
+    }
+
+private:
+
+    // Common driver of the routines above. For each sample k, write( S, buffer, k ) is called after the polygon has been closed in S; buffer is a per-thread scratch space of (n + 1) * d Reals, in which write can stage the output before conversion.
+
+    template<bool vertex_pos_Q, bool quot_space_Q, typename Write_T>
+    void CreateCompact(
+        const Int sample_count, const Int thread_count, Write_T && write
+    ) const
+    {
+        SampleScheduler scheduler ( Settings(), 0, sample_count, thread_count );
+
+        WorkerSet workers = PrepareWorkers( thread_count );
+
+        ParallelDo(
+            [&,this]( const Int thread )
+            {
+                Sampler & S = workers[thread];
+
+                RandomStreamCursor cursor = RandomStream();
+
+                Tensor1<Real,Int> buffer ( (edge_count_ + 1) * AmbDim );
+
+                scheduler.Work( thread, [&]( const Int k_begin, const Int k_end )
+                {
+                    ClosedPolygonLoop<vertex_pos_Q,quot_space_Q>( S, cursor, k_begin, k_end,
+                        [&]( const Int k )
+                        {
+                            write( S, buffer.data(), k );
+                        }
+                    );
+                });
+            },
+            thread_count
+        );
+    }
+
+    static void ConvertToFloat32( cptr<Real> a, mptr<float> b, const Int n )
+    {
+        for( Int i = 0; i < n; ++i )
+        {
+            b[i] = static_cast<float>(a[i]);
+        }
+    }
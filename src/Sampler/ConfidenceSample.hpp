@@ -22,7 +22,8 @@ public:
             return confidenceSample<true>(
                 F_list,
                 sample_means, sample_variances, errors, radii,
-                max_sample_count, thread_count, confidence, chunk_size, relativeQ, verboseQ
+                max_sample_count, thread_count, confidence, chunk_size, relativeQ, verboseQ,
+                std::string(), 0
             );
         }
         else
@@ -30,122 +31,647 @@ public:
             return confidenceSample<false>(
                 F_list,
                 sample_means, sample_variances, errors, radii,
-                max_sample_count, thread_count, confidence, chunk_size, relativeQ, verboseQ
+                max_sample_count, thread_count, confidence, chunk_size, relativeQ, verboseQ,
+                std::string(), 0
             );
         }
     }
 
 
-private:
-
+    /*!
+     * @brief Like `ConfidenceSample`, but writes a checkpoint to `checkpoint_file` after every `checkpoint_interval` chunks and at the end. If `checkpoint_file` already exists, the run is resumed from there.
+     *
+     * A checkpoint contains the estimator state (see `CoBarS::ConfidenceState`), the number of samples done, the elapsed time, and the states of the pseudorandom number generators of all threads. It is replaced atomically, so a killed run can always be resumed from its last checkpoint by calling this routine again with the same arguments and settings. The result is then the same bit for bit as that of an uninterrupted run, provided that the samples are assigned to the threads deterministically, i.e., `Settings().use_seed` is set or `Settings().use_dynamic_scheduling` is not set.
+     *
+     * A run that was stopped by `max_sample_count` can be continued by calling this routine with a larger `max_sample_count`, or with smaller `radii`.
+     *
+     * @return The number of samples drawn, or 0 if `checkpoint_file` does not belong to this run.
+     */
 
-    template<bool quotient_space_Q>
-    Int confidenceSample(
+    Int ResumableConfidenceSample(
+        const std::string & checkpoint_file,
+        const Int  checkpoint_interval,
         const std::vector< std::shared_ptr<RandomVariable_T> > & F_list,
         mptr<Real> sample_means,
         mptr<Real> sample_variances,
         mptr<Real> errors,
-        cptr<Real> radii,  // desired radii of the confidence intervals
+        cptr<Real> radii,
         const Int  max_sample_count,
-        const Int  thread_count,
+        const bool quotient_space_Q,
+        const Int  thread_count = 1,
+        const Real confidence = 0.95,
+        const Int  chunk_size = 1000000,
+        const bool relativeQ = false,
+        const bool verboseQ = true
+    ) const
+    {
+        const Int interval = std::max( checkpoint_interval, static_cast<Int>(1) );
+        
+        if ( quotient_space_Q )
+        {
+            return confidenceSample<true>(
+                F_list,
+                sample_means, sample_variances, errors, radii,
+                max_sample_count, thread_count, confidence, chunk_size, relativeQ, verboseQ,
+                checkpoint_file, interval
+            );
+        }
+        else
+        {
+            return confidenceSample<false>(
+                F_list,
+                sample_means, sample_variances, errors, radii,
+                max_sample_count, thread_count, confidence, chunk_size, relativeQ, verboseQ,
+                checkpoint_file, interval
+            );
+        }
+    }
+
+
+    /*!
+     * @brief Registers control variables for `ConfidenceSample`, `ResumableConfidenceSample`, `ShardedConfidenceSample`, and `AccumulateConfidenceState`.
+     *
+     * A control variable is a random variable `G` whose expectation `mu` is known exactly or from a previous run -- w.r.t. the same measure as the sampled random variables, i.e., on the polygon space or on its quotient by rotations, depending on `quotient_space_Q`. Instead of the mean of `F`, the sampling routines then estimate the mean of `F - sum_j beta_j (G_j - mu_j)` with regression coefficients `beta_j` that are estimated on the fly; see `CoBarS::ConfidenceState`. If `F` is strongly correlated with the `G_j`, this needs far fewer samples for the same confidence radius. The control variables are evaluated on every sample, so they should be cheap.
+     *
+     * @param G_list The control variables.
+     *
+     * @param G_means Their expectations; of size `G_list.size()`.
+     *
+     * @return `false` if the sizes do not match; then no control variables are used.
+     */
+
+    bool SetControlVariables(
+        const std::vector< std::shared_ptr<RandomVariable_T> > & G_list,
+        const std::vector<Real> & G_means
+    )
+    {
+        if( G_list.size() != G_means.size() )
+        {
+            eprint(ClassName()+"::SetControlVariables: G_list and G_means have different sizes.");
+            
+            ClearControlVariables();
+            
+            return false;
+        }
+        
+        control_list_  = G_list;
+        control_means_ = G_means;
+        
+        return true;
+    }
+
+    void ClearControlVariables()
+    {
+        control_list_.clear();
+        control_means_.clear();
+    }
+
+
+    /*!
+     * @brief The estimator state of the last call to `ConfidenceSample` that finished (a copy, so that it is not changed by later calls); it can be merged with the states of other runs on disjoint random streams; see `CoBarS::ConfidenceState`.
+     */
+
+    ConfidenceState_T LastConfidenceState() const
+    {
+        const std::lock_guard<std::mutex> lock ( confidence_state_mutex_ );
+        
+        return confidence_state_;
+    }
+
+    /*!
+     * @brief Samples the random variables in `F_list` on the samples `k_begin`, ..., `k_end - 1` and adds their moments to `state`.
+     *
+     * In reproducible mode (`Settings().use_seed`), the sample indices determine the random numbers; so runs on disjoint index ranges -- e.g., in different processes -- can be merged with `ConfidenceState::Merge`. If `state` is empty, it is initialized for `F_list`.
+     *
+     * In randomized quasi-Monte Carlo mode (`Settings().use_qmc`), the samples of all scramblings are pooled in `state`; its confidence intervals then do not apply. Use `ConfidenceSample` for RQMC error estimates.
+     *
+     * @return `false` if `state` belongs to different random variables; then nothing is done.
+     */
+
+    bool AccumulateConfidenceState(
+        const std::vector< std::shared_ptr<RandomVariable_T> > & F_list,
+        ConfidenceState_T & state,
+        const Int  k_begin,
+        const Int  k_end,
+        const bool quotient_space_Q,
+        const Int  thread_count = 1
+    ) const
+    {
+        ConfidenceState_T empty_state = NewConfidenceState( F_list );
+
+        if( !state.SameVariablesQ( empty_state ) )
+        {
+            if( state.SampleCount() > 0 )
+            {
+                eprint(ClassName()+"::AccumulateConfidenceState: state belongs to different random variables.");
+
+                return false;
+            }
+
+            state = std::move( empty_state );
+        }
+
+        WorkerSet workers = PrepareWorkers( thread_count );
+
+        AccumulatorArray moments_acc ( thread_count, state.MomentCount() );
+
+        if( quotient_space_Q )
+        {
+            accumulateConfidenceStates<true>( F_list, &state, 1, k_begin, k_end, thread_count, workers, moments_acc );
+        }
+        else
+        {
+            accumulateConfidenceStates<false>( F_list, &state, 1, k_begin, k_end, thread_count, workers, moments_acc );
+        }
+
+        return true;
+    }
+
+private:
+
+    static std::vector<std::string> RandomVariableTags(
+        const std::vector< std::shared_ptr<RandomVariable_T> > & F_list
+    )
+    {
+        std::vector<std::string> tags;
+
+        tags.reserve( F_list.size() );
+
+        for( RandomVariable_Ptr F : F_list )
+        {
+            tags.push_back( F->Tag() );
+        }
+
+        return tags;
+    }
+
+    // An empty estimator state for F_list and the registered control variables.
+
+    ConfidenceState_T NewConfidenceState(
+        const std::vector< std::shared_ptr<RandomVariable_T> > & F_list
+    ) const
+    {
+        return ConfidenceState_T( RandomVariableTags( F_list ), RandomVariableTags( control_list_ ), control_means_ );
+    }
+
+    // Samples [k_begin,k_end) with thread_count threads (the samplers in workers) and adds the moments of sample k to states[k % state_count]. All states must belong to the same random variables. moments_acc must have one row per thread and state_count * states[0].MomentCount() entries per row. Retired random variables (of states[0]) are not evaluated; the control variables are evaluated on every sample.
+
+    template<bool quotient_space_Q>
+    void accumulateConfidenceStates(
+        const std::vector< std::shared_ptr<RandomVariable_T> > & F_list,
+        ConfidenceState_T * states,
+        const Int state_count,
+        const Int k_begin,
+        const Int k_end,
+        const Int thread_count,
+        WorkerSet & workers,
+        AccumulatorArray & moments_acc
+    ) const
+    {
+        const ConfidenceState_T & state = states[0];
+        
+        const Int fun_count = state.FunCount();
+        
+        const Int mom_count = state.MomentCount();
+        
+        const Int mom_stride = fun_count + 1;
+        
+        std::vector<Int> active;
+        
+        for( Int i = 0; i < fun_count; ++i )
+        {
+            if( state.ActiveQ(i) )
+            {
+                active.push_back(i);
+            }
+        }
+        
+        const Int c_count = state.ControlCount();
+        
+        // The workers evaluate the random variables followed by the control variables.
+        std::vector< std::shared_ptr<RandomVariable_T> > FG_list ( F_list );
+        
+        FG_list.insert( FG_list.end(), control_list_.begin(), control_list_.end() );
+        
+        SampleScheduler scheduler ( Settings(), k_begin, k_end, thread_count );
+        
+        ParallelDo(
+            [&,this]( const Int thread )
+            {
+                Time start = Clock::now();
+                
+                Sampler & S = workers[thread];
+                
+                RandomStreamCursor cursor = RandomStream();
+                
+                S.LoadRandomVariablesCached( FG_list );
+                
+                moments_acc.SetZero( thread );
+                
+                Real * row = &moments_acc[thread][0];
+                
+                std::vector<Real> KG ( static_cast<Size_T>(c_count) );
+                
+                scheduler.Work( thread, [&]( const Int a, const Int b )
+                {
+                    ClosedPolygonLoop<true,quotient_space_Q>( S, cursor, a, b,
+                        [&]( const Int k )
+                        {
+                            Real * moments = &row[(k % state_count) * mom_count];
+                            
+                            mptr<Real> m_0 = &moments[0 * mom_stride];
+                            mptr<Real> m_1 = &moments[1 * mom_stride];
+                            mptr<Real> m_2 = &moments[2 * mom_stride];
+                            mptr<Real> m_3 = &moments[3 * mom_stride];
+                            
+                            // Sums for the control variables; see ConfidenceState.
+                            mptr<Real> g_KG   = &moments[ConfidenceState_T::RowCount * mom_stride];
+                            mptr<Real> g_KKG  = &g_KG [c_count];
+                            mptr<Real> g_KKGG = &g_KKG[c_count];
+                            mptr<Real> g_KKFG = &g_KKGG[c_count * c_count];
+                            
+                            Real K = 0;
+                        
+                            if constexpr ( quotient_space_Q )
+                            {
+                                K = S.EdgeQuotientSpaceSamplingWeight();
+                            }
+                            else
+                            {
+                                K = S.EdgeSpaceSamplingWeight();
+                            }
+                        
+                            for( Int j = 0; j < c_count; ++j )
+                            {
+                                KG[static_cast<Size_T>(j)] = K * S.EvaluateRandomVariable( fun_count + j );
+                                
+                                g_KG [j] += KG[static_cast<Size_T>(j)];
+                                g_KKG[j] += K * KG[static_cast<Size_T>(j)];
+                                
+                                for( Int l = 0; l < c_count; ++l )
+                                {
+                                    g_KKGG[c_count * j + l] += KG[static_cast<Size_T>(j)] * KG[static_cast<Size_T>(l)];
+                                }
+                            }
+                        
+                            for( const Int i : active )
+                            {
+                                const Real F = S.EvaluateRandomVariable(i);
+                                const Real KF = K * F;
+                            
+                                m_0[i] += KF;
+                                m_1[i] += KF * KF;
+                                m_2[i] += KF * K ;
+                                m_3[i] += KF * F;
+                                
+                                for( Int j = 0; j < c_count; ++j )
+                                {
+                                    g_KKFG[c_count * i + j] += KF * KG[static_cast<Size_T>(j)];
+                                }
+                            }
+                        
+                            m_0[fun_count] += K;
+                            m_1[fun_count] += K * K;
+                        }
+                    );
+                });
+                
+                Time stop = Clock::now();
+             
+                logprint("Thread " + ToString(thread) + " done. Time elapsed = " + ToString( Tools::Duration(start, stop) ) + "." );
+                
+            },
+            thread_count
+        );
+        
+        Tensor1<Real,Int> chunk_moments ( moments_acc.Size(), zero );
+        
+        moments_acc.ReduceTo( chunk_moments.data(), thread_count );
+        
+        // The number of k < x with k % state_count == r.
+        auto count_below = [state_count]( const Int x, const Int r )
+        {
+            return (x > r) ? (x - r - 1) / state_count + 1 : Int(0);
+        };
+        
+        for( Int r = 0; r < state_count; ++r )
+        {
+            states[r].AddMoments(
+                &chunk_moments[r * mom_count],
+                static_cast<std::uint64_t>( count_below( k_end, r ) - count_below( k_begin, r ) )
+            );
+        }
+    }
+
+    // The stopping rule of ConfidenceSample: Geary's condition holds and the confidence interval of each random variable with radius radii[i] has at least the desired confidence.
+
+    bool ConfidenceReachedQ(
+        const ConfidenceState_T & state,
+        cptr<Real> radii,
         const Real confidence,
-        const Int  chunk_size,
         const bool relativeQ,
-        const bool verboseQ
+        const bool verboseQ,
+        const Real total_time
     ) const
     {
-        // Samples the random variables in F_list until the radii of the confidence intervals of each function are lower or equal to the prescribed radii (or until max_sample_count samples have been drawn, whatever happens first).
+        // Check Geary condition
+        if( !state.GearyConditionQ() )
+        {
+            wprint("Geary condition failed.");
+            
+            return false;
+        }
         
-        ptic(ClassName()+"::ConfidenceSample");
+        if( verboseQ )
+        {
+            valprint("N", state.SampleCount() );
+            
+            valprint("  total_time ", total_time );
+        }
+        
+        bool completed = true;
+        
+        // Check stopping criterion for each random variable.
+                        
+        for( Int i = 0; i < state.FunCount(); ++i )
+        {
+            const Real current_confidence = state.CurrentConfidence( i, radii[i], relativeQ );
+
+            if( verboseQ )
+            {
+                const Real T = state.Mean(i);
+                
+                const Real absolute_radius = relativeQ ? radii[i] * T : radii[i];
+                
+                print( "  Current estimate of " + state.Tags()[static_cast<Size_T>(i)] + " = " +  ToString(T) + " +/- " + ToString(absolute_radius) + " with confidence = " + ToString(current_confidence) + ( state.ActiveQ(i) ? "." : " (retired after " + ToString(state.SampleCount(i)) + " samples)." ) );
+            }
+            
+            completed = completed && ( current_confidence > confidence );
+        }
+        
+        return completed;
+    }
+
+    // Settings().retire_converged: Stops the evaluation of the random variables that already satisfy the stopping rule; their estimates are frozen.
+
+    void RetireConvergedVariables(
+        ConfidenceState_T & state,
+        cptr<Real> radii,
+        const Real confidence,
+        const bool relativeQ
+    ) const
+    {
+        if( !state.GearyConditionQ() )
+        {
+            return;
+        }
         
+        for( Int i = 0; i < state.FunCount(); ++i )
+        {
+            if( state.ActiveQ(i) && (state.CurrentConfidence( i, radii[i], relativeQ ) > confidence) )
+            {
+                state.Retire(i);
+            }
+        }
+    }
+
+    // Writes the results of ConfidenceSample.
+
+    void WriteConfidenceResults(
+        const ConfidenceState_T & state,
+        mptr<Real> sample_means,
+        mptr<Real> sample_variances,
+        mptr<Real> errors,
+        cptr<Real> radii,
+        const Real confidence,
+        const bool relativeQ
+    ) const
+    {
+        for( Int i = 0; i < state.FunCount(); ++i )
+        {
+            sample_means[i]     = state.Mean(i);
+            sample_variances[i] = state.SampleVariance(i);
+            errors[i]           = state.Error( i, radii[i], confidence, relativeQ );
+        }
+    }
+
+    bool ConfidenceArgumentsValidQ( const Real confidence ) const
+    {
         if( (confidence < zero) )
         {
             eprint(ClassName()+"::ConfidenceSample: confidence level " + ToString(confidence) + " is smaller than zero. Aborting." );
             
-            return 0;
+            return false;
         }
         
         if( (confidence > one) )
         {
             eprint(ClassName()+"::ConfidenceSample: confidence level " + ToString(confidence) + " is greater than 1. Aborting." );
             
-            return 0;
+            return false;
         }
         
         if( (confidence > small_one) )
         {
             wprint(ClassName()+"::ConfidenceSample: confidence level " + ToString(confidence) + " is too close to 1. Computing max_sample_count samples" );
-//
-//            return 0;
+        }
+        
+        return true;
+    }
+
+    template<bool quotient_space_Q>
+    Int confidenceSample(
+        const std::vector< std::shared_ptr<RandomVariable_T> > & F_list,
+        mptr<Real> sample_means,
+        mptr<Real> sample_variances,
+        mptr<Real> errors,
+        cptr<Real> radii,  // desired radii of the confidence intervals
+        const Int  max_sample_count,
+        const Int  thread_count,
+        const Real confidence,
+        const Int  chunk_size,
+        const bool relativeQ,
+        const bool verboseQ,
+        const std::string & checkpoint_file,    // empty: no checkpoints
+        const Int  checkpoint_interval
+    ) const
+    {
+        // Samples the random variables in F_list until the radii of the confidence intervals of each function are lower or equal to the prescribed radii (or until max_sample_count samples have been drawn, whatever happens first).
+        
+        ptic(ClassName()+"::ConfidenceSample");
+        
+        if( !ConfidenceArgumentsValidQ( confidence ) )
+        {
+            ptoc(ClassName()+"::ConfidenceSample");
+            
+            return 0;
         }
         
         ptic("Preparation");
         
         const Int fun_count = static_cast<Int>(F_list.size());
-                
-              
+        
         if( verboseQ )
         {
-            valprint( "dimension       ", AmbDim            );
-            valprint( "edge_count      ", edge_count_       );
-            valprint( "fun_count       ", fun_count         );
-            valprint( "thread_count    ", thread_count      );
-            valprint( "confidence level", confidence        );
-            
-            if( relativeQ )
-            {
-                print("Using relative error measures.");
-            }
-            else
-            {
-                print("Using absolute error measures.");
-            }
-            
-            print("ConfidenceSample is computing means for the following random variables:");
-            
-            for( RandomVariable_Ptr F : F_list )
-            {
-                print("    " + F->Tag());
-            }
+            PrintConfidenceSampleInfo( F_list, thread_count, confidence, relativeQ );
         }
         
         Int N = 0;
         
         Real total_time = 0;
         
-        moments_.template Resize<false>( 4, fun_count + 1 );
-        moments_.SetZero();
+        // The state is only published at the end, so that concurrent calls do not share it.
+        ConfidenceState_T state = NewConfidenceState( F_list );
         
-        // moments[0] - 1-st moments
-        // moments[1] - 2-nd moments
-        // moments[2] - moments for covariance
-        // moments[3] - moments for sample variance
+        const bool checkpointQ = !checkpoint_file.empty();
+        
+        const bool qmcQ = Settings().use_qmc;
+        
+        if( qmcQ && !QMCConfidenceArgumentsValidQ( checkpointQ ) )
+        {
+            ptoc("Preparation");
+            
+            ptoc(ClassName()+"::ConfidenceSample");
+            
+            return 0;
+        }
         
         // Prepare samplers.
         
-        std::vector<Sampler> samplers (thread_count);
+        WorkerSet workers = PrepareWorkers( thread_count );
         
-        ParallelDo(
-            [&,this]( const Int thread )
+        // Randomized quasi-Monte Carlo mode: one state per scrambling of the Sobol sequence; see QMCConfidenceReachedQ. state holds their sum.
+        
+        const Int replicate_count = qmcQ ? static_cast<Int>(workers[0].qmc_->ReplicateCount()) : Int(1);
+        
+        std::vector<ConfidenceState_T> replicates ( qmcQ ? static_cast<Size_T>(replicate_count) : Size_T(0), state );
+        
+        std::vector<Real> qmc_means  ( qmcQ ? static_cast<Size_T>(fun_count) : Size_T(0) );
+        std::vector<Real> qmc_errors ( qmcQ ? static_cast<Size_T>(fun_count) : Size_T(0) );
+        
+        const Real t_quantile = qmcQ ? StudentT_Quantile( Scalar::Half<Real> * (one + confidence), static_cast<Real>(replicate_count - 1) ) : zero;
+        
+        // Each thread accumulates its moments in its own cache-line aligned row, with the same layout as the state (one copy per replicate).
+        
+        AccumulatorArray moments_acc ( thread_count, replicate_count * state.MomentCount() );
+        
+        CheckpointWriter header = CheckpointHeader(
+            CheckpointKind::ConfidenceSample, state.Tags(), thread_count, chunk_size
+        );
+        
+        header.Put( static_cast<std::uint64_t>(quotient_space_Q) );
+        header.Put( static_cast<std::uint64_t>(Settings().use_adaptive_chunks) );
+        header.Put( static_cast<std::uint64_t>(Settings().retire_converged) );
+        header.PutString( NewConfidenceState( F_list ).Serialize() );
+        
+        if( checkpointQ && CheckpointExistsQ( checkpoint_file ) )
+        {
+            CheckpointReader r;
+            
+            std::uint64_t N_ = 0;
+            
+            std::string state_data;
+            
+            bool okQ = r.Load( checkpoint_file )
+                && r.Expect( header.Data() )
+                && r.Get( N_ )
+                && r.Get( total_time )
+                && r.GetString( state_data )
+                && state.Deserialize( state_data );
+            
+            for( ConfidenceState_T & replicate : replicates )
             {
-                Sampler S ( EdgeLengths().data(), Rho().data(), EdgeCount(), Settings() );
-                                
-                S.LoadRandomVariables( F_list );
+                okQ = okQ && r.GetString( state_data ) && replicate.Deserialize( state_data );
+            }
+            
+            okQ = okQ && GetRandomEngines( r, workers, thread_count ) && r.AtEndQ();
+            
+            if( !okQ )
+            {
+                eprint(ClassName()+"::ResumableConfidenceSample: File " + checkpoint_file + " is not a checkpoint of this run. Aborting.");
                 
-                S.moments_.template Resize<false>( 4, fun_count + 1 );
+                StoreConfidenceState( NewConfidenceState( F_list ) );
                 
-                samplers[thread] = std::move(S);
+                ptoc("Preparation");
                 
-            },
-            thread_count
-        );
+                ptoc(ClassName()+"::ConfidenceSample");
+                
+                return 0;
+            }
+            
+            N = static_cast<Int>(N_);
+            
+            print("Resuming from checkpoint " + checkpoint_file + " after " + ToString(N) + " samples.");
+        }
         
+        auto write_checkpoint = [&,this]()
+        {
+            CheckpointWriter w = header;
+            
+            w.Put( static_cast<std::uint64_t>(N) );
+            w.Put( total_time );
+            w.PutString( state.Serialize() );
+            
+            for( const ConfidenceState_T & replicate : replicates )
+            {
+                w.PutString( replicate.Serialize() );
+            }
+            
+            PutRandomEngines( w, workers, thread_count );
+            
+            if( !w.Commit( checkpoint_file ) )
+            {
+                wprint(ClassName()+"::ResumableConfidenceSample: Could not write checkpoint file " + checkpoint_file + ".");
+            }
+        };
         
         ptoc("Preparation");
         
-        std::mutex moment_mutex;
+        auto confidence_reached = [&,this]()
+        {
+            return qmcQ
+                ? QMCConfidenceReachedQ( replicates, radii, t_quantile, relativeQ, verboseQ, total_time, qmc_means.data(), qmc_errors.data() )
+                : ConfidenceReachedQ( state, radii, confidence, relativeQ, verboseQ, total_time );
+        };
+        
+        // A resumed run stops right away if the uninterrupted run would have stopped at the checkpoint.
+        bool completed = (N > 0) && ( (N > max_sample_count) || confidence_reached() );
+        
+        const bool adaptiveQ = Settings().use_adaptive_chunks;
+        
+        // Retired random variables would leave the replicates of RQMC mode with different samples.
+        const bool retireQ = Settings().retire_converged && !qmcQ;
+        
+        Int next_chunk_size = chunk_size;
+        
+        Real first_prediction = 0;
+        
+        // The size of the next chunk depends only on the state, so a resumed run continues with the same chunks.
+        auto predict = [&]()
+        {
+            const Real prediction = qmcQ
+                ? QMCPredictedSampleCount( state, qmc_means.data(), qmc_errors.data(), radii, relativeQ )
+                : PredictedSampleCount( state, radii, confidence, relativeQ );
+            
+            if( first_prediction <= zero )
+            {
+                first_prediction = prediction;
+            }
+            
+            if( verboseQ )
+            {
+                valprint("  predicted N", prediction );
+            }
+            
+            next_chunk_size = AdaptiveChunkSize( N, prediction, chunk_size, max_sample_count );
+        };
+        
+        if( adaptiveQ && (N > 0) && !completed )
+        {
+            predict();
+        }
         
-        bool completed = false;
+        Int unsaved_chunk_count = 0;
         
         ptic("Sampling");
         
@@ -153,68 +679,25 @@ private:
         {
             Time start_time = Clock::now();
             
-            ParallelDo(
-                [&,this]( const Int thread )
+            if( qmcQ )
+            {
+                accumulateConfidenceStates<quotient_space_Q>(
+                    F_list, replicates.data(), replicate_count, N, N + next_chunk_size, thread_count, workers, moments_acc
+                );
+                
+                state = NewConfidenceState( F_list );
+                
+                for( const ConfidenceState_T & replicate : replicates )
                 {
-                    Time start = Clock::now();
-                    
-                    const Int k_begin = JobPointer( chunk_size, thread_count, thread     );
-                    const Int k_end   = JobPointer( chunk_size, thread_count, thread + 1 );
-                    
-                    const Int repetitions = k_end - k_begin;
-                    
-                    Sampler & S = samplers[thread];
-                    
-                    S.moments_.SetZero();
-                    
-                    for( Int k = 0; k < repetitions; ++k )
-                    {
-                        S.RandomizeInitialEdgeVectors();
-
-                        S.computeConformalClosure<true,quotient_space_Q>();
-                        
-                        Real K = 0;
-                        
-                        if constexpr ( quotient_space_Q )
-                        {
-                            K = S.EdgeQuotientSpaceSamplingWeight();
-                        }
-                        else
-                        {
-                            K = S.EdgeSpaceSamplingWeight();
-                        }
-                        
-                        for( Int i = 0; i < fun_count; ++i )
-                        {
-                            const Real F = S.EvaluateRandomVariable(i);
-                            const Real KF = K * F;
-                            
-                            S.moments_[0][i] += KF;
-                            S.moments_[1][i] += KF * KF;
-                            S.moments_[2][i] += KF * K ;
-                            S.moments_[3][i] += KF * F;
-
-                        }
-                        
-                        S.moments_[0][fun_count] += K;
-                        S.moments_[1][fun_count] += K * K;
-                    }
-                    
-                    {
-                        const std::lock_guard<std::mutex> lock ( moment_mutex );
-                        
-                        add_to_buffer(
-                            S.moments_.data(), moments_.data(), 4 * (fun_count+1)
-                        );
-                    }
-                    
-                    Time stop = Clock::now();
-                 
-                    logprint("Thread " + ToString(thread) + " done. Time elapsed = " + ToString( Tools::Duration(start, stop) ) + "." );
-                    
-                },
-                thread_count
-            );
+                    (void)state.Merge( replicate );
+                }
+            }
+            else
+            {
+                accumulateConfidenceStates<quotient_space_Q>(
+                    F_list, &state, 1, N, N + next_chunk_size, thread_count, workers, moments_acc
+                );
+            }
             
             Time stop_time = Clock::now();
             
@@ -222,7 +705,14 @@ private:
 
             total_time += time;
             
-            N += chunk_size;
+            N += next_chunk_size;
+            
+            if( checkpointQ && (++unsaved_chunk_count >= checkpoint_interval) )
+            {
+                write_checkpoint();
+                
+                unsaved_chunk_count = 0;
+            }
             
             if( N > max_sample_count )
             {
@@ -230,157 +720,305 @@ private:
                 break;
             }
             
-            const Real Bessel_corr = Frac<Real>( N, N-1 );
-            
-            const Real mean_K = Frac<Real>( moments_[0][fun_count], N );
+            completed = confidence_reached();
             
-            const Real var_K  = Bessel_corr * ( Frac<Real>( moments_[1][fun_count], N ) - mean_K * mean_K );
-            
-            const Real mean_Y = mean_K;
-            
-            const Real var_Y  = Frac<Real>( var_K, N );
-            
-            const Real Geary_factor = mean_Y / std::sqrt( var_Y );
-            
-            // Check Geary condition
-            if( Geary_factor < static_cast<Real>(3) )
+            if( retireQ && !completed )
             {
-                wprint("Geary condition failed.");
-                
-                completed = false;
+                RetireConvergedVariables( state, radii, confidence, relativeQ );
             }
-            else
+            
+            if( adaptiveQ && !completed )
             {
+                predict();
                 
-                if( verboseQ )
+                if( next_chunk_size <= 0 )
                 {
-                    dump(N)
-                    
-                    valprint("  total_time ", total_time );
-                }
-                
-                completed = true;
-                
-                // Check stopping criterion for each random variable.
-                                
-                for( Int i = 0; i < fun_count; ++i )
-                {
-                    const Real mean_KF  = Frac<Real>( moments_[0][i], N );
-                    
-                    const Real var_KF   = Bessel_corr * ( Frac<Real>( moments_[1][i], N ) - mean_KF * mean_KF );
-                    
-                    const Real cov_KF_K = Bessel_corr * ( Frac<Real>( moments_[2][i], N ) - mean_KF * mean_K  );
-                    
-                    const Real mean_X = mean_KF;
-                    
-                    const Real var_X  = Frac<Real>( var_KF, N );
-                    
-                    const Real cov_XY = Frac<Real>( cov_KF_K, N );
-                    
-                    const Real T = mean_X / mean_Y;
-                    
-                    const Real absolute_radius = relativeQ ? radii[i] * T : radii[i];
-                    
-                    // TODO: Boundary of checked world.
-                    
-                    const GearyTransform<Real> G ( mean_X, mean_Y, var_X, cov_XY, var_Y );
-                                    
-                    // t - G( T ) is a standard Gaussian.
-                    // See Geary - The Frequency Distribution of the Quotient of Two Normal Variates (1930)
-                    // https://www.jstor.org/stable/2342070
-                    
-                    const Real z_lo = G( T - absolute_radius );
-                    const Real z_hi = G( T + absolute_radius );
-                    
-                    // Check for sufficient confidence.
-                    
-                    const Real current_confidence = N_CDF(z_hi) - N_CDF(z_lo);
-
-                    if( verboseQ )
-                    {
-//                        dump(N)
-//                        
-//                        valprint("  total_time ", total_time );
-                        
-                        print( "  Current estimate of " + F_list[i]->Tag() + " = " +  ToString(T) + " +/- " + ToString(absolute_radius) + " with confidence = " + ToString(current_confidence) + "." );
-                    }
-                    
-                    completed = completed && ( current_confidence > confidence );
+                    wprint(ClassName()+"::ConfidenceSample: Maximal number of samples reached. Sampling aborted after " + ToString(N) + " samples.");
+                    break;
                 }
             }
-            
         }
         
         ptoc("Sampling");
         
+        if( adaptiveQ && verboseQ )
+        {
+            print("Predicted N after the first chunk = " + ToString(first_prediction) + "; actual N = " + ToString(N) + ".");
+        }
+        
+        if( retireQ && verboseQ )
+        {
+            print("Samples per random variable:");
+            
+            for( Int i = 0; i < fun_count; ++i )
+            {
+                print("    " + state.Tags()[static_cast<Size_T>(i)] + ": " + ToString(state.SampleCount(i)) );
+            }
+        }
+        
+        if( checkpointQ && (unsaved_chunk_count > 0) )
+        {
+            write_checkpoint();
+        }
+        
         ptic("Postprocessing");
         
-        const Real Bessel_corr = Frac<Real>( N, N-1 );
+        WriteConfidenceResults( state, sample_means, sample_variances, errors, radii, confidence, relativeQ );
         
-        const Real mean_K = Frac( moments_[0][fun_count], N );
+        if( qmcQ )
+        {
+            for( Int i = 0; i < fun_count; ++i )
+            {
+                sample_means[i] = qmc_means[static_cast<Size_T>(i)];
+                errors[i]       = qmc_errors[static_cast<Size_T>(i)];
+            }
+        }
         
-        const Real var_K  = Bessel_corr * ( Frac( moments_[1][fun_count], N ) - mean_K * mean_K );
+        ptoc("Postprocessing");
         
-        const Real mean_Y = mean_K;
+        StoreConfidenceState( std::move(state) );
         
-        const Real var_Y  = Frac( var_K, N );
+        ptoc(ClassName()+"::ConfidenceSample");
         
+        return N;
+    }
+    
+    // Makes state the result of LastConfidenceState. If several calls run concurrently, the one that finishes last wins.
+    
+    void StoreConfidenceState( ConfidenceState_T && state ) const
+    {
+        const std::lock_guard<std::mutex> lock ( confidence_state_mutex_ );
         
-        for( Int i = 0; i < fun_count; ++i )
+        confidence_state_ = std::move( state );
+    }
+
+    // Randomized quasi-Monte Carlo mode (Settings().use_qmc).
+    //
+    // The samples of replicate r are the RQMC points of the r-th independent scrambling of the Sobol sequence. So the estimates T_r = replicates[r].Mean(i) are independent and identically distributed, and the mean of the T_r has the confidence interval
+    //
+    //     mean +/- t_quantile * s / sqrt(R),
+    //
+    // where s is the sample standard deviation of the T_r and t_quantile is the quantile of Student's t-distribution with R - 1 degrees of freedom. In contrast to ConfidenceReachedQ, this does not assume that the errors shrink like 1/sqrt(N). Writes the means and the radii to means and errors.
+
+    bool QMCConfidenceReachedQ(
+        const std::vector<ConfidenceState_T> & replicates,
+        cptr<Real> radii,
+        const Real t_quantile,
+        const bool relativeQ,
+        const bool verboseQ,
+        const Real total_time,
+        mptr<Real> means,
+        mptr<Real> errors
+    ) const
+    {
+        const Int R = static_cast<Int>(replicates.size());
+        
+        const ConfidenceState_T & first = replicates[0];
+        
+        std::uint64_t N = 0;
+        
+        for( const ConfidenceState_T & replicate : replicates )
+        {
+            N += replicate.SampleCount();
+        }
+        
+        if( verboseQ )
+        {
+            valprint("N", N );
+            
+            valprint("  total_time ", total_time );
+        }
+        
+        bool completed = true;
+        
+        for( Int i = 0; i < first.FunCount(); ++i )
         {
-            const Real mean_KF  = Frac<Real>( moments_[0][i], N );
+            Real mean = 0;
             
-            const Real var_KF   = Bessel_corr * ( Frac<Real>( moments_[1][i], N ) - mean_KF * mean_KF );
+            for( const ConfidenceState_T & replicate : replicates )
+            {
+                mean += replicate.Mean(i);
+            }
             
-            const Real cov_KF_K = Bessel_corr * ( Frac<Real>( moments_[2][i], N ) - mean_KF * mean_K  );
+            mean /= static_cast<Real>(R);
             
-            const Real mean_X = mean_KF;
-
-            const Real var_X  = Frac<Real>( var_KF, N );
+            Real var = 0;
             
-            const Real cov_XY = Frac<Real>( cov_KF_K, N );
+            for( const ConfidenceState_T & replicate : replicates )
+            {
+                var += (replicate.Mean(i) - mean) * (replicate.Mean(i) - mean);
+            }
             
-            const GearyTransform<Real> G ( mean_X, mean_Y, var_X, cov_XY, var_Y );
+            var /= static_cast<Real>(R - 1);
             
-            const Real T = mean_X / mean_Y;
-
-            const Real absolute_radius = relativeQ ? radii[i] * T : radii[i];
+            means[i]  = mean;
+            errors[i] = t_quantile * std::sqrt( var / static_cast<Real>(R) );
             
-            // Interval bisection to find the actual confidence radius.
+            const Real absolute_radius = relativeQ ? radii[i] * std::abs(mean) : radii[i];
             
-            auto P = [T,&G]( const Real b )
+            if( verboseQ )
             {
-                return N_CDF( G( T + b ) ) - N_CDF( G( T - b ) );
-            };
+                print( "  Current estimate of " + first.Tags()[static_cast<Size_T>(i)] + " = " +  ToString(mean) + " +/- " + ToString(errors[i]) + " (desired radius = " + ToString(absolute_radius) + ")." );
+            }
             
-            Real a = 0;
-            Real b = absolute_radius;
+            completed = completed && std::isfinite( errors[i] ) && ( errors[i] <= absolute_radius );
+        }
+        
+        return completed;
+    }
+
+    // Like PredictedSampleCount, but from the radii of QMCConfidenceReachedQ. RQMC errors usually shrink faster than 1 / sqrt(N), so this errs on the large side.
+
+    Real QMCPredictedSampleCount(
+        const ConfidenceState_T & state,
+        cptr<Real> means,
+        cptr<Real> errors,
+        cptr<Real> radii,
+        const bool relativeQ
+    ) const
+    {
+        const Real N = static_cast<Real>(state.SampleCount());
+        
+        Real prediction = N;
+        
+        for( Int i = 0; i < state.FunCount(); ++i )
+        {
+            const Real absolute_radius = relativeQ ? radii[i] * std::abs(means[i]) : radii[i];
             
-            // Extend the search interval to make sure that the actual confidence radius lies within [a,b)
-            while( P(b) <= confidence )
+            if( !std::isfinite( errors[i] ) || !(absolute_radius > zero) )
             {
-                a = b;
-                
-                b *= static_cast<Real>(2);
+                return zero;
             }
             
-            const Real error = BisectionSearch<1>( std::move(P), a, b, confidence, 0.0001 );
+            prediction = std::max( prediction, N * (errors[i] / absolute_radius) * (errors[i] / absolute_radius) );
+        }
+        
+        return prediction;
+    }
+
+    bool QMCConfidenceArgumentsValidQ( const bool checkpointQ ) const
+    {
+        if( Settings().qmc_replicate_count < Int(2) )
+        {
+            eprint(ClassName()+"::ConfidenceSample: Settings().qmc_replicate_count must be at least 2 for error estimates in randomized quasi-Monte Carlo mode. Aborting." );
             
-            sample_means[i]     = T;
-            sample_variances[i] = Bessel_corr * ( Frac( moments_[3][i], moments_[0][fun_count] ) - T * T );
-            errors[i]           = error;
+            return false;
         }
         
+        if( checkpointQ && !Settings().use_seed )
+        {
+            eprint(ClassName()+"::ResumableConfidenceSample: Checkpoints in randomized quasi-Monte Carlo mode require Settings().use_seed. Aborting." );
+            
+            return false;
+        }
         
-        ptoc("Postprocessing");
+        return true;
+    }
+
+    // Adaptive chunk sizing (Settings().use_adaptive_chunks).
+    //
+    // The radius of the confidence interval of a fixed level shrinks like 1 / sqrt(N). So, if state.Error(i,...) is the current radius for random variable i, then it needs about N * (error / radius)^2 samples in total. We return the maximum over all random variables, or 0 if the estimates are not reliable yet (i.e., Geary's condition fails).
+
+    Real PredictedSampleCount(
+        const ConfidenceState_T & state,
+        cptr<Real> radii,
+        const Real confidence,
+        const bool relativeQ
+    ) const
+    {
+        if( !state.GearyConditionQ() )
+        {
+            return zero;
+        }
         
-        moments_.template Resize<false>(0,0);
+        const Real N = static_cast<Real>(state.SampleCount());
         
-        ptoc(ClassName()+"::ConfidenceSample");
+        Real prediction = N;
         
-        return N;
+        for( Int i = 0; i < state.FunCount(); ++i )
+        {
+            if( !state.ActiveQ(i) )
+            {
+                continue;
+            }
+            
+            const Real absolute_radius = relativeQ ? radii[i] * state.Mean(i) : radii[i];
+            
+            const Real ratio = state.Error( i, radii[i], confidence, relativeQ ) / absolute_radius;
+            
+            prediction = std::max( prediction, N * ratio * ratio );
+        }
+        
+        return std::isfinite(prediction) ? prediction : zero;
     }
 
+    // The size of the next chunk: We aim 2% beyond the prediction, so that a slight underestimate does not cost another chunk. Without a prediction, we double N. The chunk has at least chunk_size / 16 samples; and at most 8 N, because predictions from few samples are unreliable. The chunk never crosses max_sample_count; 0 means that max_sample_count is reached.
 
+    static Int AdaptiveChunkSize(
+        const Int  N,
+        const Real prediction,
+        const Int  chunk_size,
+        const Int  max_sample_count
+    )
+    {
+        if( N >= max_sample_count )
+        {
+            return 0;
+        }
+        
+        const Real min_chunk = static_cast<Real>( std::max( Int(1), chunk_size / 16 ) );
+        const Real max_chunk = static_cast<Real>( std::max( chunk_size, 8 * N ) );
+        
+        const Real target = (prediction > zero)
+            ? std::ceil( static_cast<Real>(1.02) * prediction ) - static_cast<Real>(N)
+            : static_cast<Real>( std::max( chunk_size, N ) );
+        
+        const Real chunk = std::min( std::max( target, min_chunk ), max_chunk );
+        
+        return std::min( static_cast<Int>(chunk), max_sample_count - N );
+    }
 
-
+    void PrintConfidenceSampleInfo(
+        const std::vector< std::shared_ptr<RandomVariable_T> > & F_list,
+        const Int  thread_count,
+        const Real confidence,
+        const bool relativeQ
+    ) const
+    {
+        valprint( "dimension       ", AmbDim            );
+        valprint( "edge_count      ", edge_count_       );
+        valprint( "fun_count       ", F_list.size()     );
+        valprint( "thread_count    ", thread_count      );
+        valprint( "confidence level", confidence        );
+        
+        if( relativeQ )
+        {
+            print("Using relative error measures.");
+        }
+        else
+        {
+            print("Using absolute error measures.");
+        }
+        
+        if( Settings().use_qmc )
+        {
+            print("Using randomized quasi-Monte Carlo with " + ToString(Settings().qmc_replicate_count) + " independently scrambled Sobol sequences.");
+        }
+        
+        print("ConfidenceSample is computing means for the following random variables:");
+        
+        for( RandomVariable_Ptr F : F_list )
+        {
+            print("    " + F->Tag());
+        }
+        
+        if( !control_list_.empty() )
+        {
+            print("Using the following control variables:");
+            
+            for( Size_T j = 0; j < control_list_.size(); ++j )
+            {
+                print("    " + control_list_[j]->Tag() + " with expectation " + ToString(control_means_[j]) );
+            }
+        }
+    }
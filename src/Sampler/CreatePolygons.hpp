@@ -27,40 +27,21 @@ private:
         const Int thread_count
     ) const
     {
+        SampleScheduler scheduler ( Settings(), 0, sample_count, thread_count );
+        
+        WorkerSet workers = PrepareWorkers( thread_count );
+        
         ParallelDo(
             [&,this]( const Int thread )
             {
                 Time start = Clock::now();
-                
-                const Int k_begin = JobPointer( sample_count, thread_count, thread     );
-                const Int k_end   = JobPointer( sample_count, thread_count, thread + 1 );
-
-                Sampler S ( EdgeLengths().data(), Rho().data(), EdgeCount(), Settings() );
 
-                for( Int k = k_begin; k < k_end; ++k )
+                Sampler & S = workers[thread];
+                
+                RandomStreamCursor cursor = RandomStream();
+                
+                auto write = [&]( const Int k )
                 {
-                    if constexpr ( p_in_Q || x_in_Q )
-                    {
-                        if constexpr ( p_in_Q )
-                        {
-                            S.ReadInitialVertexPositions(p_in,k);
-                        }
-                        else
-                        {
-                            S.ReadInitialEdgeVectors(x_in,k);
-                        }
-                    }
-                    else
-                    {
-                        S.RandomizeInitialEdgeVectors();
-                    }
-                    
-                    if constexpr ( w_Q || y_Q || q_Q || edge_space_Q || quot_space_Q )
-                    {
-                        S.computeConformalClosure<q_Q,quot_space_Q>();
-                    }
-                    
-                    
                     if constexpr ( p_out_Q )
                     {
                         S.WriteInitialVertexCoordiantes(p_out,k);
@@ -88,14 +69,58 @@ private:
                     
                     if constexpr ( edge_space_Q )
                     {
-                        K_edge_space[k] = S.EdgeSpaceSamplingWeight();
+                        K_edge_space[k] = S.OutputEdgeSpaceSamplingWeight();
                     }
                     
                     if constexpr ( quot_space_Q )
                     {
-                        K_quot_space[k] = S.EdgeQuotientSpaceSamplingWeight();
+                        K_quot_space[k] = S.OutputEdgeQuotientSpaceSamplingWeight();
+                    }
+                };
+                
+                constexpr bool closeQ = w_Q || y_Q || q_Q || edge_space_Q || quot_space_Q;
+                
+                scheduler.Work( thread, [&]( const Int k_begin, const Int k_end )
+                {
+                    if constexpr ( !(p_in_Q || x_in_Q) && closeQ )
+                    {
+                        ClosedPolygonLoop<q_Q,quot_space_Q>( S, cursor, k_begin, k_end, write );
+                    }
+                    else
+                    {
+                        for( Int k = k_begin; k < k_end; ++k )
+                        {
+                            if constexpr ( p_in_Q || x_in_Q )
+                            {
+                                if constexpr ( p_in_Q )
+                                {
+                                    S.ReadInitialVertexPositions(p_in,k);
+                                }
+                                else
+                                {
+                                    S.ReadInitialEdgeVectors(x_in,k);
+                                }
+                            }
+                            else if( Settings().use_qmc )
+                            {
+                                S.QuasiRandomizeInitialEdgeVectors( *S.qmc_, k );
+                            }
+                            else
+                            {
+                                cursor.Seek( S.random_engine, k );
+                            
+                                S.RandomizeInitialEdgeVectors();
+                            }
+                        
+                            if constexpr ( closeQ )
+                            {
+                                S.computeConformalClosure<q_Q,quot_space_Q>();
+                            }
+                        
+                            write(k);
+                        }
                     }
-                }
+                });
                 
                 Time stop = Clock::now();
                 
@@ -0,0 +1,79 @@
+private:
+
+    // Splitting the loops over the edges of a single polygon across threads (see SamplerSettings::polygon_thread_count). Each thread gets a contiguous range of edges; reductions are combined in the order of the ranges, so that the results depend on the number of threads only by roundoff, but not on their scheduling.
+
+    // Each thread gets at least this many edges; below that, the cost of starting the threads outweighs the gain.
+    static constexpr Int MinEdgesPerThread = 16384;
+
+    Int EdgeThreadCount() const
+    {
+        if constexpr ( fixedQ )
+        {
+            return Int(1);
+        }
+        else
+        {
+            return std::max( Int(1),
+                std::min( Settings().polygon_thread_count, edge_count_ / MinEdgesPerThread )
+            );
+        }
+    }
+
+    // Calls fun( thread, i_begin, i_end ) for each of the EdgeThreadCount() ranges [i_begin,i_end) that partition the edges, each on its own thread.
+
+    template<typename F>
+    void EdgeParallelDo( F && fun ) const
+    {
+        const Int thread_count = EdgeThreadCount();
+
+        if( thread_count <= Int(1) )
+        {
+            fun( Int(0), Int(0), edgeCount() );
+        }
+        else
+        {
+            ParallelDo(
+                [&,this]( const Int thread )
+                {
+                    const Int i_begin = JobPointer( edgeCount(), thread_count, thread     );
+                    const Int i_end   = JobPointer( edgeCount(), thread_count, thread + 1 );
+
+                    fun( thread, i_begin, i_end );
+                },
+                thread_count
+            );
+        }
+    }
+
+    // Lets fun( i_begin, i_end ) compute the partial result of each range of EdgeParallelDo and adds them up with combine( partial, result ) in the order of the ranges. With a single thread, this is just fun( 0, edgeCount() ).
+
+    template<typename T, typename F, typename C>
+    T EdgeParallelReduce( F && fun, C && combine ) const
+    {
+        const Int thread_count = EdgeThreadCount();
+
+        if( thread_count <= Int(1) )
+        {
+            return fun( Int(0), edgeCount() );
+        }
+        else
+        {
+            std::vector<T> partial ( thread_count );
+
+            EdgeParallelDo(
+                [&]( const Int thread, const Int i_begin, const Int i_end )
+                {
+                    partial[thread] = fun( i_begin, i_end );
+                }
+            );
+
+            T result = partial[0];
+
+            for( Int thread = 1; thread < thread_count; ++thread )
+            {
+                combine( partial[thread], result );
+            }
+
+            return result;
+        }
+    }
@@ -14,9 +14,18 @@ public:
     
     virtual void ReadEdgeLengths( const Real * const r ) override
     {
+        // A default-constructed instance with fixed edge count has no storage for the edge lengths.
+        (void)CheckedEdgeCount( static_cast<Int>(r_.Size()) );
+        
         r_.Read(r);
         
         total_r_inv = Inv( r_.Total() );
+        
+        ComputeEdgeConstants();
+        
+        ReleaseWorkers();
+        
+        batch_.reset();
     }
     
     
@@ -28,25 +37,57 @@ public:
     virtual void ReadRho( const Real * const rho ) override
     {
         rho_.Read(rho);
+        
+        ComputeEdgeConstants();
+        
+        ReleaseWorkers();
+        
+        batch_.reset();
     }
     
 private:
     
     virtual void ComputeInitialShiftVector() override
     {
+        w_ = EdgeParallelReduce<Vector_T>(
+            [this]( const Int i_begin, const Int i_end )
+            {
+                Vector_T w;
+                
+                accumulateInitialShiftVector( i_begin, i_end, w );
+                
+                return w;
+            },
+            []( const Vector_T & partial, Vector_T & result )
+            {
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    result[j] += partial[j];
+                }
+            }
+        );
+        
+        // Normalize in that case that r does not sum up to 1.
+        w_ *= total_r_inv;
+    }
+    
+    void accumulateInitialShiftVector( const Int i_begin, const Int i_end, Vector_T & w ) const
+    {
+        // Accumulates the edges i_begin,...,i_end-1 into w; i_begin < i_end is assumed.
+        
         if constexpr ( zerofyfirstQ )
         {
-            w_.SetZero();
+            w.SetZero();
             
-            for( Int i = 0; i < edge_count_; ++i )
+            for( Int i = i_begin; i < i_end; ++i )
             {
-                Vector_T x_i ( x_, i );
+                Vector_T x_i = GetVector( x_, i );
                 
                 const Real r_i = r_[i];
                 
                 for( Int j = 0; j < AmbDim; ++j )
                 {
-                    w_[j] += x_i[j] * r_i;
+                    w[j] += x_i[j] * r_i;
                 }
             }
         }
@@ -54,33 +95,29 @@ private:
         {
             // Overwrite by first summand.
             {
-                Vector_T x_i ( x_, 0 );
+                Vector_T x_i = GetVector( x_, i_begin );
                 
-                const Real r_i = r_[0];
+                const Real r_i = r_[i_begin];
 
                 for( Int j = 0; j < AmbDim; ++j )
                 {
-                    w_[j] = x_i[j] * r_i;
+                    w[j] = x_i[j] * r_i;
                 }
             }
 
             // Add-in the others.
-            for( Int i = 1; i < edge_count_; ++i )
+            for( Int i = i_begin + 1; i < i_end; ++i )
             {
-                Vector_T x_i ( x_, i );
+                Vector_T x_i = GetVector( x_, i );
                 
                 const Real r_i = r_[i];
 
                 for( Int j = 0; j < AmbDim; ++j )
                 {
-                    w_[j] += x_i[j] * r_i;
+                    w[j] += x_i[j] * r_i;
                 }
             }
         }
-
-        
-        // Normalize in that case that r does not sum up to 1.
-        w_ *= total_r_inv;
     }
 
 public:
@@ -117,6 +154,11 @@ public:
         return errorestimator;
     }
     
+    virtual bool SucceededQ() const override
+    {
+        return succeededQ;
+    }
+    
     virtual Int IterationCount() const override
     {
         return iter;
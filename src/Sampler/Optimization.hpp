@@ -2,53 +2,257 @@ private:
 
 
     /*!
-     * @brief Runs Newton-like algorithm to find the conformal closure of the open polygon (loaded with ReadInitialEdgeVectors or generated with ReadInitialEdgeVectors). Afterwards, the resulting closed polygon can be accessed with routines *EdgeVectors. The conformal barycenter can be accessed with *ShiftVector.
+     * @brief Runs Newton-like algorithm to find the conformal closure of the open polygon (loaded with ReadInitialEdgeVectors or generated with ReadInitialEdgeVectors). Afterwards, the resulting closed polygon can be accessed with routines *EdgeVectors. The conformal barycenter can be accessed with *ShiftVector. The iteration is selected by Settings().solver_strategy.
      */
 
     void Optimize()
     {
+        switch( Settings().solver_strategy )
+        {
+            case SolverStrategy::Newton_Residual:
+            {
+                optimize<SolverStrategy::Newton_Residual>();
+                break;
+            }
+            case SolverStrategy::Chebyshev:
+            {
+                optimize<SolverStrategy::Chebyshev>();
+                break;
+            }
+            case SolverStrategy::TrustRegion:
+            {
+                optimize<SolverStrategy::TrustRegion>();
+                break;
+            }
+            case SolverStrategy::Gradient_Hyperbolic:
+            {
+                optimize<SolverStrategy::Gradient_Hyperbolic>();
+                break;
+            }
+            case SolverStrategy::Gradient_Planar:
+            {
+                optimize<SolverStrategy::Gradient_Planar>();
+                break;
+            }
+            case SolverStrategy::Newton:
+            default:
+            {
+                optimize<SolverStrategy::Newton>();
+                break;
+            }
+        }
+    }
+    
+    template<SolverStrategy strategy>
+    void optimize()
+    {
+        // Only the Chebyshev step needs the third moment of the shifted edge vectors.
+        constexpr bool third_Q = (strategy == SolverStrategy::Chebyshev);
+        
         const Int max_iter = Settings().max_iter;
         
         iter = 0;
         
-        Shift();
+        succeededQ = false;
         
-        DifferentialAndHessian_Hyperbolic();
+        trust_radius = Settings().trust_region_radius;
         
-        SearchDirection_Hyperbolic();
+        // The shift of the edge vectors is fused into the assembly of F_ and DF_ and into the evaluation of the potential. Thus y_ is not written during the iteration.
+        
+        ShiftDifferentialAndHessian_Hyperbolic<third_Q>();
+        
+        SearchDirection<strategy>();
         
         // The main loop.
         while( ( iter < max_iter ) && continueQ )
         {
             ++iter;
             
-            LineSearch_Hyperbolic_Potential();
-            
-            DifferentialAndHessian_Hyperbolic();
+            if constexpr ( strategy == SolverStrategy::Newton_Residual )
+            {
+                // Shifts the edge vectors to y_ and assembles F_ and DF_ from there.
+                LineSearch_Hyperbolic_Residual();
+            }
+            else
+            {
+                if constexpr ( strategy == SolverStrategy::TrustRegion )
+                {
+                    TrustRegionStep();
+                }
+                else
+                {
+                    LineSearch_Hyperbolic_Potential();
+                }
+                
+                ShiftDifferentialAndHessian_Hyperbolic<third_Q>();
+            }
             
-            SearchDirection_Hyperbolic();
+            SearchDirection<strategy>();
         }
+        
+        // Write the final edge vectors to y_.
+        Shift();
     }
     
-    Real Potential()
+    template<SolverStrategy strategy>
+    void SearchDirection()
     {
-        const Real zz = Dot(z_,z_);
+        // The decisions whether to continue are based on the Newton system for all strategies.
+        SearchDirection_Hyperbolic();
         
-        const Real a = big_one + zz;
-        const Real c = (big_one-zz);
+        if constexpr ( strategy == SolverStrategy::Chebyshev )
+        {
+            ChebyshevCorrection();
+        }
+        else if constexpr ( strategy == SolverStrategy::Gradient_Hyperbolic )
+        {
+            Gradient_Hyperbolic();
+        }
+        else if constexpr ( strategy == SolverStrategy::Gradient_Planar )
+        {
+            Gradient_Planar();
+        }
+    }
+    
+    // Along the search ray z = s u_ of the line search, we have <y_i,z> = s <y_i,u_>. So PotentialAndRayDots evaluates the potential at s u_ and caches the dot products <y_i,u_> in y_dot_u_; then PotentialOnRay evaluates the potential at further points of the ray from y_dot_u_ alone, without shifting the edge vectors again.
+    
+    Real PotentialAndRayDots( const Real s )
+    {
+        // The shifted vectors are computed on the fly; y_ is not accessed.
         
-        const Real b = one/c;
+        const Real ww = Dot(w_,w_);
         
-        Real value = 0;
+        const Real one_minus_ww = big_one - ww;
+        const Real one_plus_ww  = big_one + ww;
         
-        for( Int i = 0; i < edge_count_; ++i )
+        if( ww <= norm_threshold )
         {
-            Vector_T y_i (y_,i);
-            
-            value += r_[i] * std::log( std::abs( (a - two * Dot(y_i,z_) ) * b ) );
+            return rayPotential( s,
+                [=,this]( const Int i )
+                {
+                    const Real y_dot_u_i = Dot( ShiftedEdgeVector<false>( i, one_minus_ww, one_plus_ww ), u_ );
+                    
+                    y_dot_u_[i] = y_dot_u_i;
+                    
+                    return y_dot_u_i;
+                }
+            );
+        }
+        else
+        {
+            return rayPotential( s,
+                [=,this]( const Int i )
+                {
+                    const Real y_dot_u_i = Dot( ShiftedEdgeVector<true>( i, one_minus_ww, one_plus_ww ), u_ );
+                    
+                    y_dot_u_[i] = y_dot_u_i;
+                    
+                    return y_dot_u_i;
+                }
+            );
         }
+    }
+    
+    Real PotentialOnRay( const Real s ) const
+    {
+        return rayPotential( s,
+            [this]( const Int i )
+            {
+                return y_dot_u_[i];
+            }
+        );
+    }
+    
+    template<typename Dot_T>
+    Real rayPotential( const Real s, Dot_T && y_dot_u ) const
+    {
+        // The potential at z = s u_ is
+        //
+        //      sum_i r_i log( (1 + |z|^2 - 2 s <y_i,u_>) / (1 - |z|^2) ) / sum_i r_i.
+        
+        const Real zz = s * s * Dot(u_,u_);
+        
+        const Real a     = big_one + zz;
+        const Real two_s = two * s;
+        
+        const Real log_c = std::log( std::abs( big_one - zz ) );
+        
+        auto add = []( const Real partial, Real & result )
+        {
+            result += partial;
+        };
         
-        return value * total_r_inv;
+        if( equilateralQ )
+        {
+            // All r_i are equal, so we can multiply the factors in blocks of ProductBlockSize and take one logarithm per block. We keep lane_count independent products, so that the multiplications vectorize.
+            
+            constexpr Int lane_count = static_cast<Int>(BatchLanes);
+            constexpr Int chunk_size = lane_count * ProductBlockSize;
+            
+            const Real value = EdgeParallelReduce<Real>(
+                [&,this]( const Int i_begin, const Int i_end )
+                {
+                    Real value = 0;
+                    
+                    for( Int i_0 = i_begin; i_0 < i_end; i_0 += chunk_size )
+                    {
+                        Real prod [lane_count];
+                        
+                        for( Int l = 0; l < lane_count; ++l )
+                        {
+                            prod[l] = one;
+                        }
+                        
+                        if( i_end - i_0 >= chunk_size )
+                        {
+                            for( Int k = 0; k < ProductBlockSize; ++k )
+                            {
+                                for( Int l = 0; l < lane_count; ++l )
+                                {
+                                    prod[l] *= a - two_s * y_dot_u( i_0 + lane_count * k + l );
+                                }
+                            }
+                        }
+                        else
+                        {
+                            for( Int i = i_0; i < i_end; ++i )
+                            {
+                                prod[(i - i_0) % lane_count] *= a - two_s * y_dot_u( i );
+                            }
+                        }
+                        
+                        for( Int l = 0; l < lane_count; ++l )
+                        {
+                            value += std::log( std::abs( prod[l] ) );
+                        }
+                    }
+                    
+                    return value;
+                },
+                add
+            );
+            
+            return value * Inv<Real>( edgeCount() ) - log_c;
+        }
+        else
+        {
+            const Real value = EdgeParallelReduce<Real>(
+                [&,this]( const Int i_begin, const Int i_end )
+                {
+                    Real value = 0;
+                    
+                    for( Int i = i_begin; i < i_end; ++i )
+                    {
+                        value += r_[i] * std::log( std::abs( a - two_s * y_dot_u( i ) ) );
+                    }
+                    
+                    return value;
+                },
+                add
+            );
+            
+            return value * total_r_inv - log_c;
+        }
     }
     
     
@@ -61,6 +265,9 @@ private:
         
         const Real u_norm = u_.Norm();
         
+        // The backtracking steps have to start from the current point again.
+        const Vector_T w_0 = w_;
+        
         // exponential map shooting from 0 to tau * u_.
         Times( tau * tanhc(tau * u_norm), u_, z_ );
 
@@ -95,6 +302,8 @@ private:
                 
                 Times( tau * tanhc(tau * u_norm), u_, z_ );
                 
+                w_ = w_0;
+                
                 // Shift the point z_ along -w_ to get new updated point w_.
                 InverseShift();
                 
@@ -134,7 +343,7 @@ private:
             
             // const Real phi_0 = 0;
             
-            Real phi_tau = Potential();
+            Real phi_tau = PotentialAndRayDots( tau * tanhc(tau * u_norm) );
             
             ArmijoQ = phi_tau /*- phi_0*/ - sigma * tau * Dphi_0 < 0;
             
@@ -150,9 +359,12 @@ private:
                 
                 tau = std::max( tau_1, tau_2 );
                 
-                Times( tau * tanhc(tau * u_norm), u_, z_ );
+                const Real s = tau * tanhc(tau * u_norm);
                 
-                phi_tau = Potential();
+                Times( s, u_, z_ );
+                
+                // Only the dot products cached by PotentialAndRayDots are needed.
+                phi_tau = PotentialOnRay( s );
                 
                 ArmijoQ = phi_tau  /*- phi_0*/ - sigma * tau * Dphi_0 < 0;
             }
@@ -161,12 +373,231 @@ private:
         // Shift the point z_ along -w_ to get new updated point w_.
         InverseShift();
         
-        // Shift the input measure along w to 0 to simplify gradient, Hessian, and update computation .
-        Shift();
+        // The input measure is shifted along w_ to 0 in ShiftDifferentialAndHessian_Hyperbolic.
+    }
+    
+    void TrustRegionStep()
+    {
+        // Dogleg step in the trust region of radius trust_radius. The potential is modeled by g_factor * ( <F_,v> + 1/2 <v,DF_ v> ); the step is accepted if the potential decreases by at least Armijo_slope_factor times the decrease of the model. Otherwise, the trust region shrinks by Armijo_shrink_factor and we try again, at most max_backtrackings times.
+        
+        if( !linesearchQ )
+        {
+            // Kantorovich condition satisfied; take the full Newton step.
+            Times( tanhc(u_.Norm()), u_, z_ );
+            
+            InverseShift();
+            
+            return;
+        }
+        
+        const Real eta   = Settings().Armijo_slope_factor;
+        const Real gamma = Settings().Armijo_shrink_factor;
+        
+        // The Newton step computed by SearchDirection_Hyperbolic.
+        const Vector_T u_N = u_;
+        
+        const Real u_N_norm = u_N.Norm();
+        
+        // The minimizer of the model along -F_ (Cauchy point).
+        Vector_T u_C;
+        
+        Times( - Dot(F_,F_) / DF_.InnerProduct(F_,F_), F_, u_C );
+        
+        const Real u_C_norm = u_C.Norm();
+        
+        Int backtrackings = 0;
+        
+        while( true )
+        {
+            if( u_N_norm <= trust_radius )
+            {
+                u_ = u_N;
+            }
+            else if( u_C_norm >= trust_radius )
+            {
+                Times( trust_radius / u_C_norm, u_C, u_ );
+            }
+            else
+            {
+                // The point where the segment from u_C to u_N leaves the trust region.
+                Vector_T d;
+                
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    d[j] = u_N[j] - u_C[j];
+                }
+                
+                const Real dd = Dot(d,d);
+                const Real cd = Dot(u_C,d);
+                
+                const Real tau = ( std::sqrt( cd * cd + dd * (trust_radius * trust_radius - u_C_norm * u_C_norm) ) - cd ) / dd;
+                
+                for( Int j = 0; j < AmbDim; ++j )
+                {
+                    u_[j] = u_C[j] + tau * d[j];
+                }
+            }
+            
+            const Real u_norm = u_.Norm();
+            
+            const Real predicted = - g_factor * ( Dot(F_,u_) + half * DF_.InnerProduct(u_,u_) );
+            
+            const Real s = tanhc(u_norm);
+            
+            if( predicted <= static_cast<Real>(64) * Scalar::eps<Real> )
+            {
+                // The potential is evaluated only up to a few machine epsilons, so the comparison would be meaningless; we accept the step.
+                Times( s, u_, z_ );
+                
+                break;
+            }
+            
+            // The potential vanishes at 0.
+            const Real ratio = - PotentialAndRayDots( s ) / predicted;
+            
+            if( (ratio >= eta) || (backtrackings >= Settings().max_backtrackings) )
+            {
+                if( ratio < static_cast<Real>(0.25) )
+                {
+                    trust_radius = gamma * u_norm;
+                }
+                else if( (ratio > static_cast<Real>(0.75)) && (u_norm >= small_one * trust_radius) )
+                {
+                    trust_radius *= two;
+                }
+                
+                Times( s, u_, z_ );
+                
+                break;
+            }
+            
+            ++backtrackings;
+            
+            trust_radius = gamma * u_norm;
+        }
+        
+        // Shift the point z_ along -w_ to get new updated point w_.
+        InverseShift();
     }
     
     void DifferentialAndHessian_Hyperbolic()
     {
+        // Assembles F_ and DF_ from the shifted edge vectors stored in y_.
+        
+        accumulateDifferentialAndHessian<false>(
+            [this]( const Int i )
+            {
+                return GetVector( y_, i );
+            }
+        );
+        
+        finalizeDifferentialAndHessian();
+    }
+    
+    template<bool third_Q = false>
+    void ShiftDifferentialAndHessian_Hyperbolic()
+    {
+        // Fused version of Shift() and DifferentialAndHessian_Hyperbolic(): Shifts each entry of x_ along w_ and accumulates it into F_ and DF_ right away. Thus, only x_ is streamed and y_ is not written.
+        
+        const Real ww = Dot(w_,w_);
+        
+        const Real one_minus_ww = big_one - ww;
+        const Real one_plus_ww  = big_one + ww;
+        
+        if( ww <= norm_threshold )
+        {
+            accumulateDifferentialAndHessian<third_Q>(
+                [=,this]( const Int i )
+                {
+                    return ShiftedEdgeVector<false>( i, one_minus_ww, one_plus_ww );
+                }
+            );
+        }
+        else
+        {
+            accumulateDifferentialAndHessian<third_Q>(
+                [=,this]( const Int i )
+                {
+                    return ShiftedEdgeVector<true>( i, one_minus_ww, one_plus_ww );
+                }
+            );
+        }
+        
+        finalizeDifferentialAndHessian();
+        
+        if constexpr ( third_Q )
+        {
+            M3_ *= total_r_inv;
+        }
+    }
+    
+    template<bool third_Q, typename EdgeVector_T>
+    void accumulateDifferentialAndHessian( EdgeVector_T && edge_vector )
+    {
+        if( EdgeThreadCount() <= Int(1) )
+        {
+            accumulateDifferentialAndHessian<third_Q>( edge_vector, Int(0), edgeCount(), F_, DF_, M3_ );
+        }
+        else
+        {
+            // Each thread accumulates its range of edges into its own copy of F_, DF_, and M3_.
+            
+            struct Sums_T
+            {
+                Vector_T          F;
+                SymmetricMatrix_T DF;
+                ThirdMoment_T     M3;
+            };
+            
+            const Sums_T sums = EdgeParallelReduce<Sums_T>(
+                [&,this]( const Int i_begin, const Int i_end )
+                {
+                    Sums_T sums;
+                    
+                    accumulateDifferentialAndHessian<third_Q>( edge_vector, i_begin, i_end, sums.F, sums.DF, sums.M3 );
+                    
+                    return sums;
+                },
+                []( const Sums_T & partial, Sums_T & result )
+                {
+                    for( Int j = 0; j < AmbDim; ++j )
+                    {
+                        result.F[j] += partial.F[j];
+                        
+                        for( Int k = j; k < AmbDim; ++k )
+                        {
+                            result.DF[j][k] += partial.DF[j][k];
+                        }
+                    }
+                    
+                    if constexpr ( third_Q )
+                    {
+                        for( Int t = 0; t < ThirdMomentCount; ++t )
+                        {
+                            result.M3[t] += partial.M3[t];
+                        }
+                    }
+                }
+            );
+            
+            F_  = sums.F;
+            DF_ = sums.DF;
+            
+            if constexpr ( third_Q )
+            {
+                M3_ = sums.M3;
+            }
+        }
+    }
+    
+    template<bool third_Q, typename EdgeVector_T>
+    void accumulateDifferentialAndHessian(
+        EdgeVector_T && edge_vector, const Int i_begin, const Int i_end,
+        Vector_T & F, SymmetricMatrix_T & DF, ThirdMoment_T & M3
+    ) const
+    {
+        // Accumulates the edges i_begin,...,i_end-1 into F and DF (and into M3 if third_Q is set); i_begin < i_end is assumed.
+        
         // CAUTION: We use a different sign convention as in the paper!
         // Assemble  F = -1/2 y * r.
         // Assemble DF_ = nabla F + regulatization:
@@ -174,12 +605,17 @@ private:
         
         if constexpr ( zerofyfirstQ )
         {
-            F_.SetZero();
-            DF_.SetZero();
+            F.SetZero();
+            DF.SetZero();
+            
+            if constexpr ( third_Q )
+            {
+                M3.SetZero();
+            }
 
-            for( Int i = 0; i < edge_count_; ++i )
+            for( Int i = i_begin; i < i_end; ++i )
             {
-                Vector_T y_i ( y_, i );
+                const Vector_T y_i = edge_vector(i);
                 
                 const Real r_i = r_[i];
 
@@ -187,13 +623,18 @@ private:
                 {
                     const Real factor = r_i * y_i[j];
 
-                    F_[j] -= factor;
+                    F[j] -= factor;
 
                     for( Int k = j; k < AmbDim; ++k )
                     {
-                        DF_[j][k] -= factor * y_i[k];
+                        DF[j][k] -= factor * y_i[k];
                     }
                 }
+                
+                if constexpr ( third_Q )
+                {
+                    accumulateThirdMoment( r_i, y_i, M3 );
+                }
             }
             
         }
@@ -201,27 +642,34 @@ private:
         {
             // Filling F_ and DF_ with first summand...
             {
-                Vector_T y_i ( y_, 0 );
+                const Vector_T y_i = edge_vector(i_begin);
                 
-                const Real r_i = r_[0];
+                const Real r_i = r_[i_begin];
                 
                 for( Int j = 0; j < AmbDim; ++j )
                 {
                     const Real factor = r_i * y_i[j];
                     
-                    F_[j] = - factor;
+                    F[j] = - factor;
                     
                     for( Int k = j; k < AmbDim; ++k )
                     {
-                        DF_[j][k] = - factor * y_i[k];
+                        DF[j][k] = - factor * y_i[k];
                     }
                 }
+                
+                if constexpr ( third_Q )
+                {
+                    M3.SetZero();
+                    
+                    accumulateThirdMoment( r_i, y_i, M3 );
+                }
             }
             
             // ... and adding-in the other summands.
-            for( Int i = 1; i < edge_count_; ++i )
+            for( Int i = i_begin + 1; i < i_end; ++i )
             {
-                Vector_T y_i ( y_, i );
+                const Vector_T y_i = edge_vector(i);
                 
                 const Real r_i = r_[i];
                 
@@ -229,16 +677,48 @@ private:
                 {
                     const Real factor = r_i * y_i[j];
                     
-                    F_[j] -= factor;
+                    F[j] -= factor;
                     
                     for( Int k = j; k < AmbDim; ++k )
                     {
-                        DF_[j][k] -= factor * y_i[k];
+                        DF[j][k] -= factor * y_i[k];
                     }
                 }
+                
+                if constexpr ( third_Q )
+                {
+                    accumulateThirdMoment( r_i, y_i, M3 );
+                }
             }
         }
+    }
+    
+    static void accumulateThirdMoment( const Real r_i, const Vector_T & y_i, ThirdMoment_T & M3 )
+    {
+        // Adds r_i y_i (x) y_i (x) y_i to the entries j <= k <= l of M3.
         
+        Int t = 0;
+        
+        for( Int j = 0; j < AmbDim; ++j )
+        {
+            const Real a = r_i * y_i[j];
+            
+            for( Int k = j; k < AmbDim; ++k )
+            {
+                const Real b = a * y_i[k];
+                
+                for( Int l = k; l < AmbDim; ++l )
+                {
+                    M3[t] += b * y_i[l];
+                    
+                    ++t;
+                }
+            }
+        }
+    }
+    
+    void finalizeDifferentialAndHessian()
+    {
         // Normalize for case that the weights in r do not sum to 1.
         
         F_  *= total_r_inv;
@@ -264,7 +744,14 @@ private:
         {
             // We have to compute eigenvalue _before_ we add the regularization.
             
-            lambda_min = DF_.SmallestEigenvalue();
+            if constexpr ( (AmbDim == 2) || (AmbDim == 3) )
+            {
+                lambda_min = SymmetricSmallestEigenvalue<AmbDim,Real>( DF_ );
+            }
+            else
+            {
+                lambda_min = DF_.SmallestEigenvalue();
+            }
             
             q_Newton = four * residual / (lambda_min * lambda_min);
             
@@ -304,13 +791,87 @@ private:
             }
         }
         
-        L.Cholesky();
-        
-        L.CholeskySolve(F_,u_);
+        if constexpr ( SymmetricKernelsQ<AmbDim> )
+        {
+            SymmetricSolve<AmbDim,Real>( L, F_, u_ );
+        }
+        else
+        {
+            L.Cholesky();
+            
+            L.CholeskySolve(F_,u_);
+        }
         
         u_ *= -one;
     }
     
+    void ChebyshevCorrection()
+    {
+        // Corrects the Newton step u_ by the third derivative of the potential. At 0, the potential composed with the exponential map has the Taylor expansion
+        //
+        //      g_factor * ( <F_,v> + 1/2 <v,DF_ v> - 1/3 ( 4 <F_,v> |v|^2 + 2 M3_[v,v,v] ) ) + O(|v|^4),
+        //
+        // where DF_ is taken without the regularization. The Chebyshev step for the root of its gradient is u_ - DF_^{-1} c with
+        //
+        //      c = -4/3 ( |u_|^2 F_ + 2 <F_,u_> u_ ) - 2 M3_[u_,u_,.].
+        //
+        // Far from the barycenter, the correction need not be small; then we keep the Newton step.
+        
+        Vector_T c;
+        
+        {
+            // M3_[u_,u_,.]; each entry j <= k <= l of M3_ stands for all its permutations.
+            
+            Vector_T m (zero);
+            
+            Int t = 0;
+            
+            for( Int j = 0; j < AmbDim; ++j )
+            {
+                for( Int k = j; k < AmbDim; ++k )
+                {
+                    for( Int l = k; l < AmbDim; ++l )
+                    {
+                        const Real multiplicity = (j == l) ? Frac<Real>(1,3) : ( ((j == k) || (k == l)) ? one : two );
+                        
+                        const Real a = multiplicity * M3_[t];
+                        
+                        m[j] += a * u_[k] * u_[l];
+                        m[k] += a * u_[j] * u_[l];
+                        m[l] += a * u_[j] * u_[k];
+                        
+                        ++t;
+                    }
+                }
+            }
+            
+            const Real uu    = Dot(u_,u_);
+            const Real Fu_2  = two * Dot(F_,u_);
+            
+            for( Int j = 0; j < AmbDim; ++j )
+            {
+                c[j] = - Frac<Real>(4,3) * ( uu * F_[j] + Fu_2 * u_[j] ) - two * m[j];
+            }
+        }
+        
+        Vector_T v;
+        
+        // L still holds the regularized Hessian (or its Cholesky factor) from SearchDirection_Hyperbolic.
+        if constexpr ( SymmetricKernelsQ<AmbDim> )
+        {
+            SymmetricSolve<AmbDim,Real>( L, c, v );
+        }
+        else
+        {
+            L.CholeskySolve(c,v);
+        }
+        
+        if( Dot(v,v) <= Frac<Real>(1,4) * Dot(u_,u_) )
+        {
+            u_ -= v;
+        }
+    }
+    
     void Gradient_Hyperbolic()
     {
         Times(-g_factor_inv, F_, u_);
@@ -326,18 +887,25 @@ private:
     {
         // Shifts just the point w.
         
-        const Real ww  = Dot(w_,w_);
-        const Real wz2 = Dot(w_,z_) * two;
-        const Real zz  = Dot(z_,z_);
-    
-        const Real d = one / (big_one + wz2 + ww * zz);
-        
-        const Real a = (one - ww) * d;
-        const Real b = (one + zz + wz2) * d;
-        
-        for( Int j = 0; j < AmbDim; ++j )
+        if constexpr ( AmbDim == 2 )
+        {
+            MoebiusInverseShift_Planar( w_[0], w_[1], z_[0], z_[1] );
+        }
+        else
         {
-            w_[j] = a * z_[j] + b * w_[j];
+            const Real ww  = Dot(w_,w_);
+            const Real wz2 = Dot(w_,z_) * two;
+            const Real zz  = Dot(z_,z_);
+        
+            const Real d = one / (big_one + wz2 + ww * zz);
+            
+            const Real a = (one - ww) * d;
+            const Real b = (one + zz + wz2) * d;
+            
+            for( Int j = 0; j < AmbDim; ++j )
+            {
+                w_[j] = a * z_[j] + b * w_[j];
+            }
         }
     }
     
@@ -372,10 +940,36 @@ private:
         const Real one_minus_ww = big_one - ww;
         const Real one_plus_ww  = big_one + ww;
         
-        for( Int i = 0; i < edge_count_; ++i )
+        EdgeParallelDo(
+            [=,this]( const Int, const Int i_begin, const Int i_end )
+            {
+                for( Int i = i_begin; i < i_end; ++i )
+                {
+                    SetVector( ShiftedEdgeVector<normalizeQ>( i, one_minus_ww, one_plus_ww ), y_, i );
+                }
+            }
+        );
+    }
+    
+    template< bool normalizeQ>
+    Vector_T ShiftedEdgeVector(
+        const Int i, const Real one_minus_ww, const Real one_plus_ww
+    ) const
+    {
+        // Returns the i-th entry of x_ shifted along w_.
+        
+        Vector_T z = GetVector( x_, i );
+        
+        if constexpr ( AmbDim == 2 )
         {
-            Vector_T z ( x_, i );
+            // w_^2 does not depend on i; after inlining, the compiler hoists it out of the callers' loops.
+            const Real w2_re = w_[0] * w_[0] - w_[1] * w_[1];
+            const Real w2_im = two * w_[0] * w_[1];
             
+            MoebiusShift_Planar( z[0], z[1], w_[0], w_[1], w2_re, w2_im, one_plus_ww, z[0], z[1] );
+        }
+        else
+        {
             const Real wx2 = two * Dot(w_,z);
             
             const Real d = one / ( one_plus_ww - wx2 );
@@ -388,37 +982,12 @@ private:
             {
                 z[j] = a * z[j] + b* w_[j];
             }
-            
-            if constexpr ( normalizeQ )
-            {
-                z.Normalize();
-            }
-            
-            z.Write( y_, i );
-        }
-        
-//        for( Int i = 0; i < edge_count_; ++i )
-//        {
-//            Vector_T x_i ( x_, i );
-//            
-//            const Real wx2 = two * Dot(w_,x_i);
-//            
-//            const Real d = one / ( one_plus_ww - wx2 );
-//
-//            const Real a = one_minus_ww * d;
-//            
-//            const Real b = (wx2 - two) * d;
-//            
-//            for( Int j = 0; j < AmbDim; ++j )
-//            {
-//                x_i[j] = a * x_i[j] + b* w_[j];
-//            }
-//            
-//            if constexpr ( normalizeQ )
-//            {
-//                x_i.Normalize();
-//            }
-//            
-//            x_i.Write( y_, i );
-//        }
+        }
+        
+        if constexpr ( normalizeQ )
+        {
+            z.Normalize();
+        }
+        
+        return z;
     }
@@ -0,0 +1,39 @@
+private:
+
+    // Kernels for AmbDim == 2. We identify the point (v[0],v[1]) of the unit disk with the complex number v[0] + i v[1], so that the hyperbolic shifts become Möbius transformations. (The 2 x 2 linear algebra is in SymmetricKernels.hpp.) We spell out real and imaginary parts instead of using std::complex, whose multiplication and division check for infinities and NaNs and thus do not vectorize. All routines work on scalars, so that CoBarS::BatchSampler can call them in its loops over the lanes.
+
+    // Maps the unit vector x to (x - w)/(1 - conj(w) x) = (x - 2 w + w^2 conj(x)) / |1 - conj(w) x|^2, where w2 = w^2 and one_plus_ww = 1 + |w|^2.
+
+    static void MoebiusShift_Planar(
+        const Real x_re,  const Real x_im,
+        const Real w_re,  const Real w_im,
+        const Real w2_re, const Real w2_im,
+        const Real one_plus_ww,
+        Real & y_re, Real & y_im
+    )
+    {
+        const Real d = one / ( one_plus_ww - two * ( w_re * x_re + w_im * x_im ) );
+
+        y_re = ( x_re - two * w_re + ( w2_re * x_re + w2_im * x_im ) ) * d;
+        y_im = ( x_im - two * w_im + ( w2_im * x_re - w2_re * x_im ) ) * d;
+    }
+
+    // Overwrites w by (w + z)/(1 + conj(w) z), the point that the Möbius transformation of MoebiusShift_Planar maps to z. Since |w| < 1 and |z| < 1, the denominator does not vanish.
+
+    static void MoebiusInverseShift_Planar(
+        Real & w_re, Real & w_im, const Real z_re, const Real z_im
+    )
+    {
+        // q = 1 + conj(w) z
+        const Real q_re = one + ( w_re * z_re + w_im * z_im );
+        const Real q_im =         w_re * z_im - w_im * z_re;
+
+        const Real d = one / ( q_re * q_re + q_im * q_im );
+
+        const Real s_re = w_re + z_re;
+        const Real s_im = w_im + z_im;
+
+        // (w + z) * conj(q) / |q|^2
+        w_re = ( s_re * q_re + s_im * q_im ) * d;
+        w_im = ( s_im * q_re - s_re * q_im ) * d;
+    }
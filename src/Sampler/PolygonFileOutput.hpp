@@ -0,0 +1,198 @@
+public:
+
+    /*!
+     * @brief Generates `sample_count` random closed polygons and writes them, together with both sampling weights, to the file `path` in the format described in `CoBarS::PolygonFileHeader`. Use `CoBarS::PolygonFile` to read it.
+     *
+     * The header records the ambient dimension, the edge count, the edge lengths, `rho`, the name of the pseudorandom number generator, and the settings (including the seed, and whether the weights are stored as logarithms; see `SamplerSettings::log_weights`).
+     *
+     * @param path Path of the output file; an existing file is overwritten.
+     *
+     * @param sample_count Number of polygons to generate.
+     *
+     * @param thread_count Number of threads to use for sampling.
+     *
+     * @param memory_mapped_Q If set, the file is memory-mapped and the worker threads write the polygons directly into it; the operating system writes the pages to disk in the background. Otherwise, the polygons are generated in blocks of `block_size` samples (see `StreamSample`), and the calling thread writes each finished block to disk while the worker threads fill the next ones. The latter keeps the memory footprint bounded also if the page cache is small, or if the file system does not support `mmap` well.
+     *
+     * @param block_size Number of samples per block if `memory_mapped_Q` is not set.
+     *
+     * @return `true` on success; otherwise an error message is printed.
+     */
+
+    bool CreateRandomClosedPolygonsFile(
+        const std::string & path,
+        const Int  sample_count,
+        const Int  thread_count = 1,
+        const bool memory_mapped_Q = true,
+        const Int  block_size = 65536
+    ) const
+    {
+        ptic(ClassName()+"::CreateRandomClosedPolygonsFile");
+
+        PolygonFileHeader header = PolygonFileHeaderOf( sample_count );
+
+        const int fd = ::open( path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644 );
+
+        if( fd < 0 )
+        {
+            eprint( ClassName() + "::CreateRandomClosedPolygonsFile: Could not open file " + path + " for writing." );
+
+            ptoc(ClassName()+"::CreateRandomClosedPolygonsFile");
+
+            return false;
+        }
+
+        bool succeededQ = ( ::ftruncate( fd, static_cast<off_t>(header.file_size) ) == 0 )
+            && PWriteAll( fd, &header,         sizeof(PolygonFileHeader),         0                 )
+            && PWriteAll( fd, r_.data(),       sizeof(Real) * edge_count_,        header.r_offset   )
+            && PWriteAll( fd, rho_.data(),     sizeof(Real) * edge_count_,        header.rho_offset );
+
+        if( succeededQ && (sample_count > 0) )
+        {
+            if( memory_mapped_Q )
+            {
+                succeededQ = WritePolygonFile_MemoryMapped( fd, header, sample_count, thread_count );
+            }
+            else
+            {
+                succeededQ = WritePolygonFile_Buffered( fd, header, sample_count, thread_count, block_size );
+            }
+        }
+
+        succeededQ = (::close( fd ) == 0) && succeededQ;
+
+        if( !succeededQ )
+        {
+            eprint( ClassName() + "::CreateRandomClosedPolygonsFile: Writing to file " + path + " failed." );
+        }
+
+        ptoc(ClassName()+"::CreateRandomClosedPolygonsFile");
+
+        return succeededQ;
+    }
+
+private:
+
+    PolygonFileHeader PolygonFileHeaderOf( const Int sample_count ) const
+    {
+        PolygonFileHeader h;
+
+        h.SetLayout(
+            static_cast<std::uint32_t>(AmbDim),
+            static_cast<std::uint32_t>(sizeof(Real)),
+            static_cast<std::uint64_t>(edge_count_),
+            static_cast<std::uint64_t>(sample_count)
+        );
+
+        const std::string prng = PRNG_Name();
+
+        std::memcpy( h.prng, prng.data(), std::min( prng.size(), sizeof(h.prng) - 1 ) );
+
+        const Setting_T & s = Settings();
+
+        h.use_seed             = s.use_seed;
+        h.seed                 = s.seed;
+        h.samples_per_stream   = static_cast<std::uint64_t>(s.samples_per_stream);
+        h.max_iter             = static_cast<std::uint64_t>(s.max_iter);
+        h.max_backtrackings    = static_cast<std::uint64_t>(s.max_backtrackings);
+        h.use_linesearch       = s.use_linesearch;
+        h.log_weights          = s.log_weights;
+        h.tolerance            = static_cast<double>(s.tolerance);
+        h.give_up_tolerance    = static_cast<double>(s.give_up_tolerance);
+        h.regularization       = static_cast<double>(s.regularization);
+        h.Armijo_slope_factor  = static_cast<double>(s.Armijo_slope_factor);
+        h.Armijo_shrink_factor = static_cast<double>(s.Armijo_shrink_factor);
+
+        return h;
+    }
+
+    // pwrite may write less than requested, so we loop.
+    static bool PWriteAll(
+        const int fd, const void * buffer, const Size_T byte_count, const std::uint64_t offset
+    )
+    {
+        const char * a = static_cast<const char *>(buffer);
+
+        Size_T done = 0;
+
+        while( done < byte_count )
+        {
+            const ssize_t w = ::pwrite( fd, a + done, byte_count - done, static_cast<off_t>(offset + done) );
+
+            if( w <= 0 )
+            {
+                return false;
+            }
+
+            done += static_cast<Size_T>(w);
+        }
+
+        return true;
+    }
+
+    bool WritePolygonFile_MemoryMapped(
+        const int fd, const PolygonFileHeader & header,
+        const Int sample_count, const Int thread_count
+    ) const
+    {
+        // We map only the data sections. The offset of mmap must be a multiple of the page size; header.q_offset is 64 KiB-aligned, but we do not rely on the page size of this machine dividing that.
+        const long page_size = ::sysconf( _SC_PAGESIZE );
+
+        const std::uint64_t page = (page_size > 0) ? static_cast<std::uint64_t>(page_size) : std::uint64_t(1);
+
+        const std::uint64_t map_offset = page * (header.q_offset / page);
+
+        const Size_T map_size = static_cast<Size_T>( header.file_size - map_offset );
+
+        void * map = ::mmap(
+            nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, static_cast<off_t>(map_offset)
+        );
+
+        if( map == MAP_FAILED )
+        {
+            return false;
+        }
+
+        char * base = static_cast<char *>(map);
+
+        auto section = [&]( const std::uint64_t offset )
+        {
+            return reinterpret_cast<Real *>( base + (offset - map_offset) );
+        };
+
+        CreatePolygons<0,0,0,0,0,0,1,1,1>(
+            nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+            section( header.q_offset      ),
+            section( header.K_edge_offset ),
+            section( header.K_quot_offset ),
+            sample_count, thread_count
+        );
+
+        return ::munmap( map, map_size ) == 0;
+    }
+
+    bool WritePolygonFile_Buffered(
+        const int fd, const PolygonFileHeader & header,
+        const Int sample_count, const Int thread_count, const Int block_size
+    ) const
+    {
+        const Size_T record_size = sizeof(Real) * static_cast<Size_T>( (edge_count_ + 1) * AmbDim );
+
+        bool succeededQ = true;
+
+        // The blocks are contiguous in each section of the file, so each one needs only three writes.
+        StreamSample( {}, sample_count,
+            [&]( const SampleBlock_T & block )
+            {
+                const Size_T k = static_cast<Size_T>(block.Begin());
+                const Size_T m = static_cast<Size_T>(block.Count());
+
+                succeededQ = succeededQ
+                    && PWriteAll( fd, block.VertexPositions(),                  record_size  * m, header.q_offset      + record_size  * k )
+                    && PWriteAll( fd, block.EdgeSpaceSamplingWeights(),         sizeof(Real) * m, header.K_edge_offset + sizeof(Real) * k )
+                    && PWriteAll( fd, block.EdgeQuotientSpaceSamplingWeights(), sizeof(Real) * m, header.K_quot_offset + sizeof(Real) * k );
+            },
+            thread_count, block_size, true
+        );
+
+        return succeededQ;
+    }
@@ -8,22 +8,37 @@ public:
     {
         ptic(ClassName()+"::CreateRandomOpenPolygons");
         
+        SampleScheduler scheduler ( Settings(), 0, sample_count, thread_count );
+        
+        WorkerSet workers = PrepareWorkers( thread_count );
+        
         ParallelDo(
             [&,this]( const Int thread )
             {
                 Time start = Clock::now();
-                
-                const Int k_begin = JobPointer( sample_count, thread_count, thread     );
-                const Int k_end   = JobPointer( sample_count, thread_count, thread + 1 );
 
-                Sampler S ( EdgeLengths().data(), Rho().data(), EdgeCount(), Settings() );
-
-                for( Int k = k_begin; k < k_end; ++k )
+                Sampler & S = workers[thread];
+                
+                RandomStreamCursor cursor = RandomStream();
+                
+                scheduler.Work( thread, [&]( const Int k_begin, const Int k_end )
                 {
-                    S.RandomizeInitialEdgeVectors();
-                    
-                    S.WriteInitialVertexPositions(p,k);
-                }
+                    for( Int k = k_begin; k < k_end; ++k )
+                    {
+                        if( Settings().use_qmc )
+                        {
+                            S.QuasiRandomizeInitialEdgeVectors( *S.qmc_, k );
+                        }
+                        else
+                        {
+                            cursor.Seek( S.random_engine, k );
+                            
+                            S.RandomizeInitialEdgeVectors();
+                        }
+                        
+                        S.WriteInitialVertexPositions(p,k);
+                    }
+                });
                 
                 Time stop = Clock::now();
                 
@@ -0,0 +1,151 @@
+private:
+
+    // Reproducible mode (Settings().use_seed):
+    //
+    // Each polygon consumes exactly RandomWordCount() words of its random engine. Sample k uses the words
+    //
+    //     (k % samples_per_stream) * RandomWordCount(), ..., (k % samples_per_stream + 1) * RandomWordCount() - 1
+    //
+    // of stream k / samples_per_stream of Settings().seed; see the constructors Prng_T( seed, stream ) and the routines Prng_T::NextStream() of the pseudorandom number generators. So the randomness of sample k does not depend on how JobPointer distributes the samples over the threads.
+    //
+    // Each thread keeps one RandomStreamCursor for all the chunks it pulls from its SampleScheduler. Seek(engine,k,count) has to be called before the random numbers of the samples k, ..., k + count - 1 are drawn from engine in one go (count > 1 for the lanes of the batch engine; they must not cross the boundary of a stream). If k directly follows the previous samples, then engine just goes on (or moves to the next stream); otherwise the cursor moves its stream to stream k / samples_per_stream and skips through it to sample k. Chunks are pulled in increasing order; then the stream only has to be reconstructed when it is not the next one. If use_seed is not set, this does nothing.
+
+    class RandomStreamCursor
+    {
+    private:
+
+        const bool activeQ;
+
+        const std::uint64_t seed;
+        
+        const Int  samples_per_stream;
+        const Int  word_count;
+        
+        // The sample that follows the samples of the previous call to Seek; -1 if there is none.
+        Int k_next = -1;
+        
+        // Index of the stream that stream is at the beginning of.
+        std::uint64_t stream_index = 0;
+
+        Prng_T stream;
+
+    public:
+
+        RandomStreamCursor( const Setting_T & settings, const Int word_count_ )
+        :   activeQ            ( settings.use_seed )
+        ,   seed               ( settings.seed )
+        ,   samples_per_stream ( std::max( Int(1), settings.samples_per_stream ) )
+        ,   word_count         ( word_count_ )
+        ,   stream             ( settings.seed, 0 )
+        {}
+
+        bool ActiveQ() const
+        {
+            return activeQ;
+        }
+
+        // Number of samples from k to the end of its stream.
+        Int RemainingInStream( const Int k ) const
+        {
+            return samples_per_stream - (k % samples_per_stream);
+        }
+
+        void Seek( Prng_T & engine, const Int k, const Int count = 1 )
+        {
+            if( !activeQ )
+            {
+                return;
+            }
+            
+            const std::uint64_t target = static_cast<std::uint64_t>(k / samples_per_stream);
+            
+            if( k == k_next )
+            {
+                if( k % samples_per_stream == 0 )
+                {
+                    MoveStream( target );
+
+                    engine = stream;
+                }
+            }
+            else
+            {
+                MoveStream( target );
+                
+                engine = stream;
+
+                const Int skip = (k % samples_per_stream) * word_count;
+
+                if constexpr ( requires ( Prng_T & e, std::uint64_t n ) { e.discard( n ); } )
+                {
+                    // Jump ahead (Philox4x32, PCG64, WyRand, Xoshiro256Plus).
+                    engine.discard( static_cast<std::uint64_t>(skip) );
+                }
+                else
+                {
+                    for( Int i = 0; i < skip; ++i )
+                    {
+                        (void)engine();
+                    }
+                }
+            }
+            
+            k_next = k + count;
+        }
+        
+    private:
+        
+        void MoveStream( const std::uint64_t target )
+        {
+            if( target == stream_index + 1 )
+            {
+                stream.NextStream();
+            }
+            else if( target != stream_index )
+            {
+                stream = Prng_T( seed, target );
+            }
+            
+            stream_index = target;
+        }
+    };
+
+    // Number of words that RandomizeInitialEdgeVectors draws from the random engine.
+    Int RandomWordCount() const
+    {
+        return RandomUnitVectorsBufferSize<AmbDim>(edge_count_);
+    }
+
+    RandomStreamCursor RandomStream() const
+    {
+        return RandomStreamCursor( Settings(), RandomWordCount() );
+    }
+
+    // Randomized quasi-Monte Carlo mode (Settings().use_qmc): Returns Settings().qmc_replicate_count scramblings of the Sobol sequence of dimension RandomWordCount(); these are current if it fits the settings. The cached scramblings (qmc_) are kept until ReleaseWorkers is called or the settings ask for different ones; so, as in reproducible mode, sample k is a function of k alone. Called by WorkerSet.
+    std::shared_ptr<const ScrambledSobol> QMC( const std::shared_ptr<const ScrambledSobol> & current ) const
+    {
+        const std::uint32_t dimension = static_cast<std::uint32_t>( RandomWordCount() );
+
+        const std::uint32_t replicate_count = static_cast<std::uint32_t>( std::max( Int(1), Settings().qmc_replicate_count ) );
+
+        if(
+            current
+            && (current->Dimension() == dimension)
+            && (current->ReplicateCount() == replicate_count)
+            && (!Settings().use_seed || (current->Seed() == Settings().seed))
+        )
+        {
+            return current;
+        }
+
+        std::uint64_t seed = Settings().seed;
+
+        if( !Settings().use_seed )
+        {
+            std::random_device r;
+
+            seed = (static_cast<std::uint64_t>(r()) << 32) ^ static_cast<std::uint64_t>(r());
+        }
+
+        return std::make_shared<const ScrambledSobol>( dimension, replicate_count, seed );
+    }
@@ -0,0 +1,93 @@
+public:
+
+    /*!
+     * @brief Regenerates the closed polygons with the given sample indices of a reproducible run, in parallel.
+     *
+     * In reproducible mode (`Settings().use_seed`), the closed polygon number `k` of `CreateRandomClosedPolygons`, `Sample`, `BinnedSample`, `StreamSample`, etc. is a deterministic function of `Settings().seed`, `Settings().samples_per_stream`, `k`, the edge lengths, `rho`, and the pseudorandom number generator `Prng_T`. So a corpus of polygons can be stored as just this information (and, e.g., the sampling weights); this routine pulls out any selection of it, for example the samples with the highest weights or the samples in a certain bin.
+     *
+     * In randomized quasi-Monte Carlo mode (`Settings().use_qmc`), polygon number `k` is instead a function of `Settings().seed`, `Settings().qmc_replicate_count`, and `k`; this is replayed as well.
+     *
+     * Each index that does not directly follow its predecessor costs the construction of its random stream and a seek within it to sample `k`. Both are O(1) for `CoBarS::Philox4x32` and `CoBarS::WyRand` and O(log k) for `CoBarS::PCG64` and `CoBarS::Xoshiro256Plus`. `CoBarS::MT64` has no jump-ahead; there the seek redraws the random numbers of up to `samples_per_stream` samples, so better use one of the others for replay. Runs of consecutive indices are generated in one go.
+     *
+     * @param indices The sample indices to regenerate; of size `index_count`.
+     *
+     * @param q Target array of size at least `index_count * (n + 1) * d`. The vertex positions of polygon `indices[j]` are stored at `&q[(n + 1) * d * j]`.
+     *
+     * @param K_edge_space Target array of size at least `index_count` for the reweighting factors of the polygon space -- or a `nullptr`.
+     *
+     * @param K_quot_space Target array of size at least `index_count` for the reweighting factors of the polygon space modulo rotations -- or a `nullptr`.
+     *
+     * @param thread_count Number of threads to use.
+     *
+     * @return `false` if `Settings().use_seed` is not set; then nothing is done.
+     */
+
+    bool ReplayClosedPolygons(
+        const Int  * restrict const indices,
+        const Int                   index_count,
+              Real * restrict const q,
+              Real * restrict const K_edge_space,
+              Real * restrict const K_quot_space,
+        const Int thread_count = 1
+    ) const
+    {
+        if( !Settings().use_seed )
+        {
+            eprint( ClassName() + "::ReplayClosedPolygons: Settings().use_seed is not set, so the samples cannot be reproduced. Doing nothing." );
+
+            return false;
+        }
+
+        ptic(ClassName()+"::ReplayClosedPolygons");
+
+        SampleScheduler scheduler ( Settings(), 0, index_count, thread_count );
+
+        WorkerSet workers = PrepareWorkers( thread_count );
+
+        ParallelDo(
+            [&,this]( const Int thread )
+            {
+                Sampler & S = workers[thread];
+
+                RandomStreamCursor cursor = RandomStream();
+
+                scheduler.Work( thread, [&]( const Int j_begin, const Int j_end )
+                {
+                    for( Int j = j_begin; j < j_end; ++j )
+                    {
+                        const Int k = indices[j];
+
+                        if( Settings().use_qmc )
+                        {
+                            S.QuasiRandomizeInitialEdgeVectors( *S.qmc_, k );
+                        }
+                        else
+                        {
+                            cursor.Seek( S.random_engine, k );
+
+                            S.RandomizeInitialEdgeVectors();
+                        }
+
+                        S.template computeConformalClosure<true,true>();
+
+                        S.WriteVertexPositions( q, j );
+
+                        if( K_edge_space != nullptr )
+                        {
+                            K_edge_space[j] = S.OutputEdgeSpaceSamplingWeight();
+                        }
+
+                        if( K_quot_space != nullptr )
+                        {
+                            K_quot_space[j] = S.OutputEdgeQuotientSpaceSamplingWeight();
+                        }
+                    }
+                });
+            },
+            thread_count
+        );
+
+        ptoc(ClassName()+"::ReplayClosedPolygons");
+
+        return true;
+    }
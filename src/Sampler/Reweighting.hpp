@@ -9,83 +9,254 @@ public:
     {
         return edge_quotient_space_sampling_weight;
     }
+    
+    virtual Real EdgeSpaceSamplingLogWeight() const override
+    {
+        return edge_space_sampling_log_weight;
+    }
+    
+    virtual Real EdgeQuotientSpaceSamplingLogWeight() const override
+    {
+        return edge_quotient_space_sampling_log_weight;
+    }
+
+private:
+
 
-protected:
+    void ComputeEdgeSpaceSamplingHelper()
+    {
+        edge_space_sampling_helper
+            =
+            Frac(
+                GammaQuotient(
+                    static_cast<Real>((AmbDim-1) * (edge_count_-1)),
+                    Frac<Real>( AmbDim, 2 )
+                ),
+                Power( static_cast<Real>(2) * Sqrt( Scalar::Pi<Real>), AmbDim )
+            );
+        
+        edge_space_sampling_log_helper = std::log( edge_space_sampling_helper );
+    }
 
-    Real EdgeQuotientSpaceSamplingCorrection() const
+    void ComputeEdgeQuotientSpaceSamplingHelper()
     {
-        Tiny::SelfAdjointMatrix<AmbDim, Real, Int> Sigma;
+        edge_quotient_space_sampling_helper
+            =
+            Frac<Real>(
+                std::exp2( Scalar::Quarter<Real> * static_cast<Real>( AmbDim * (AmbDim-1) ) ),
+                SOVolume<Real>(AmbDim)
+            );
         
-        // We fill only the upper triangle of Sigma, because that's the only thing that the function Eigenvalues needs.
-      
-        if constexpr ( zerofyfirstQ )
+        edge_quotient_space_sampling_log_helper = std::log( edge_quotient_space_sampling_helper );
+    }
+    
+    // Precomputes the per-edge factors of the weight matrices. Has to be called whenever r_ or rho_ change.
+    
+    void ComputeEdgeConstants()
+    {
+        equilateralQ = true;
+        
+        for( Int i = 0; i < edgeCount(); ++i )
         {
-            Sigma.SetZero();
+            const Real r_over_rho_i = r_[i] / rho_[i];
+            
+            r_over_rho_squared_[i] = r_over_rho_i * r_over_rho_i;
+            rho_squared_[i]        = rho_[i] * rho_[i];
             
-            for( Int i = 0; i < edge_count_; ++i )
+            equilateralQ = equilateralQ && (r_[i] == r_[0]);
+        }
+    }
+    
+    // The weights as the output routines write them into arrays; see SamplerSettings::log_weights.
+    
+    Real OutputEdgeSpaceSamplingWeight() const
+    {
+        return Settings().log_weights
+            ? edge_space_sampling_log_weight
+            : edge_space_sampling_weight;
+    }
+    
+    Real OutputEdgeQuotientSpaceSamplingWeight() const
+    {
+        return Settings().log_weights
+            ? edge_quotient_space_sampling_log_weight
+            : edge_quotient_space_sampling_weight;
+    }
+
+    // Computes the weights of the current conformal closure (and, if quot_space_Q, also the one for the quotient space) in a single pass over y_. The weight of the polygon space is
+    //
+    //      K = helper * prod_i (1 + |w|^2 + 2 <w,y_i>)^(d-1) * sqrt(det(gamma)) / det(cbar).
+    //
+    // For polygons with many edges, the product can over- or underflow. So we work in the log domain: We multiply the factors in blocks of ProductBlockSize and sum the logarithms of the block products.
+    
+    template<bool quot_space_Q>
+    void ComputeSamplingWeights() const
+    {
+        // Both matrices are symmetric. In dimensions 2, 3, 4 we accumulate only their upper triangles and use closed-form determinants.
+        
+        constexpr bool symmetricQ = SymmetricKernelsQ<AmbDim>;
+        
+        using WeightMatrix_T = std::conditional_t<symmetricQ,SymmetricMatrix_T,SquareMatrix_T>;
+        
+        // The sums over the edges; with EdgeThreadCount() > 1, each thread accumulates its range of edges into its own copy.
+        struct Sums_T
+        {
+            WeightMatrix_T    gamma;
+            WeightMatrix_T    cbar;
+            SymmetricMatrix_T Sigma;
+            Real              log_prod;
+        };
+        
+        const Real ww = Dot(w_,w_);
+        
+        const Real one_plus_ww = big_one + ww;
+        
+        Sums_T sums = EdgeParallelReduce<Sums_T>(
+            [=,this]( const Int i_begin, const Int i_end )
             {
-                Vector_T y_i ( y_, i );
+                Sums_T sums;
                 
-                const Real rho_squared = rho_[i] * rho_[i];
-                
-                for( Int j = 0; j < AmbDim; ++j )
+                if constexpr ( symmetricQ )
                 {
-                    const Real factor = rho_squared * y_i[j];
-                    
-                    for( Int k = j; k < AmbDim; ++k )
-                    {
-                        Sigma[j][k] += factor * y_i[k];
-                    }
+                    sums.gamma.SetZero();
+                    sums.cbar.SetZero();
+                }
+                else
+                {
+                    sums.gamma = SquareMatrix_T(zero);
+                    sums.cbar  = SquareMatrix_T(zero);
                 }
-            }
-        }
-        else
-        {
-            // Overwrite for i = 0.
-            {
-                constexpr Int i = 0;
                 
-                Vector_T y_i ( y_, i );
+                // We fill only the upper triangle of Sigma, because that's the only thing that the function Eigenvalues needs.
+                if constexpr ( quot_space_Q )
+                {
+                    sums.Sigma.SetZero();
+                }
                 
-                const Real rho_squared = rho_[i] * rho_[i];
+                sums.log_prod = zero;
                 
-                for( Int j = 0; j < AmbDim; ++j )
+                for( Int i_0 = i_begin; i_0 < i_end; i_0 += ProductBlockSize )
                 {
-                    const Real factor = rho_squared * y_i[j];
-
-                    for( Int k = j; k < AmbDim; ++k )
+                    const Int i_1 = std::min( i_0 + ProductBlockSize, i_end );
+                    
+                    Real prod = one;
+                    
+                    for( Int i = i_0; i < i_1; ++i )
                     {
-                        Sigma[j][k] = factor * y_i[k];
+                        Vector_T y_i = GetVector( y_, i );
+                        
+                        prod *= one_plus_ww + two * Dot(w_,y_i);
+                        
+                        const Real r_i                  = r_[i];
+                        const Real r_over_rho_i_squared = r_over_rho_squared_[i];
+                        
+                        for( Int j = 0; j < AmbDim; ++j )
+                        {
+                            for( Int k = (symmetricQ ? j : Int(0)); k < AmbDim; ++k )
+                            {
+                                const Real scratch = static_cast<Real>(j==k) - y_i[j] * y_i[k];
+                                
+                                sums.gamma[j][k] += r_over_rho_i_squared * scratch;
+                                
+                                sums.cbar [j][k] += r_i * scratch;
+                            }
+                        }
+                        
+                        if constexpr ( quot_space_Q )
+                        {
+                            const Real rho_i_squared = rho_squared_[i];
+                            
+                            for( Int j = 0; j < AmbDim; ++j )
+                            {
+                                const Real factor = rho_i_squared * y_i[j];
+                                
+                                for( Int k = j; k < AmbDim; ++k )
+                                {
+                                    sums.Sigma[j][k] += factor * y_i[k];
+                                }
+                            }
+                        }
                     }
+                    
+                    sums.log_prod += std::log( prod );
                 }
-            }
-
-            // Now we add-in the other entries.
-            for( Int i = 1; i < edge_count_; ++i )
-            {
-                Vector_T y_i ( y_, i );
-                
-                const Real rho_squared = rho_[i] * rho_[i];
                 
+                return sums;
+            },
+            []( const Sums_T & partial, Sums_T & result )
+            {
                 for( Int j = 0; j < AmbDim; ++j )
                 {
-                    const Real factor = rho_squared * y_i[j];
-
-                    for( Int k = j; k < AmbDim; ++k )
+                    for( Int k = (symmetricQ ? j : Int(0)); k < AmbDim; ++k )
+                    {
+                        result.gamma[j][k] += partial.gamma[j][k];
+                        result.cbar [j][k] += partial.cbar [j][k];
+                    }
+                    
+                    if constexpr ( quot_space_Q )
                     {
-                        Sigma[j][k] += factor * y_i[k];
+                        for( Int k = j; k < AmbDim; ++k )
+                        {
+                            result.Sigma[j][k] += partial.Sigma[j][k];
+                        }
                     }
                 }
+                
+                result.log_prod += partial.log_prod;
             }
+        );
+        
+        WeightMatrix_T & gamma = sums.gamma;
+        WeightMatrix_T & cbar  = sums.cbar;
+        
+        const Real log_prod = sums.log_prod;
+        
+        // We can simply absorb the factor std::pow(2/(one_minus_ww),d) into the function chi.
+        //  cbar *= static_cast<Real>(2)/(one_minus_ww);
+        
+        Real gamma_det;
+        Real cbar_det;
+        
+        if constexpr ( symmetricQ )
+        {
+            gamma_det = SymmetricDet<AmbDim,Real>( gamma );
+            cbar_det  = SymmetricDet<AmbDim,Real>( cbar  );
         }
+        else
+        {
+            gamma_det = gamma.Det();
+            cbar_det  = cbar.Det();
+        }
+        
+        edge_space_sampling_log_weight =
+            edge_space_sampling_log_helper
+            + static_cast<Real>(AmbDim-1) * log_prod
+            + half * std::log( gamma_det )
+            - std::log( cbar_det );
         
-        Real det;
+        edge_space_sampling_weight = std::exp( edge_space_sampling_log_weight );
         
+        if constexpr ( quot_space_Q )
+        {
+            edge_quotient_space_sampling_log_weight =
+                edge_space_sampling_log_weight
+                + edge_quotient_space_sampling_log_helper
+                - half * std::log( EdgeQuotientSpaceSamplingCorrectionDet( sums.Sigma ) );
+            
+            edge_quotient_space_sampling_weight = std::exp( edge_quotient_space_sampling_log_weight );
+        }
+    }
+    
+    // Returns the product of lambda[j] + lambda[k] over all j < k, where lambda are the eigenvalues of Sigma. The quotient space weight is the edge space weight times helper / sqrt of this.
+    
+    static Real EdgeQuotientSpaceSamplingCorrectionDet( SymmetricMatrix_T & Sigma )
+    {
         if constexpr ( AmbDim == 2 )
         {
-            det = Abs( Sigma[0][0] * Sigma[1][1] - Sigma[0][1] * Sigma[0][1] );
+            // The only product lambda[0] + lambda[1] is the trace of Sigma.
+            return Abs( Sigma[0][0] + Sigma[1][1] );
         }
-        if constexpr ( AmbDim == 3 )
+        else if constexpr ( AmbDim == 3 )
         {
             // Exploiting that
             //      (lambda[0] + lambda[1]) * (lambda[0] + lambda[2]) * (lambda[1] + lambda[2])
@@ -101,7 +272,7 @@ protected:
             const Real S_20 = Sigma[0][2] * Sigma[0][2];
             const Real S_21 = Sigma[1][2] * Sigma[1][2];
             
-            det = Abs(
+            return Abs(
                   Sigma[0][0] * ( S_11 + S_22 - S_10 - S_20 )
                 + Sigma[1][1] * ( S_00 + S_22 - S_10 - S_21 )
                 + Sigma[2][2] * ( S_00 + S_11 - S_20 - S_21 )
@@ -116,7 +287,7 @@ protected:
             
             Sigma.Eigenvalues( lambda );
             
-            det = one;
+            Real det = one;
             
             for( Int j = 0; j < AmbDim; ++j )
             {
@@ -125,89 +296,7 @@ protected:
                     det *= (lambda(j)+lambda(k));
                 }
             }
-        }
-        
-        return edge_quotient_space_sampling_helper * Inv(Sqrt(det));
-    }
-
-private:
-
-
-    void ComputeEdgeSpaceSamplingHelper()
-    {
-        edge_space_sampling_helper
-            =
-            Frac(
-                GammaQuotient(
-                    static_cast<Real>((AmbDim-1) * (edge_count_-1)),
-                    Frac<Real>( AmbDim, 2 )
-                ),
-                Power( static_cast<Real>(2) * Sqrt( Scalar::Pi<Real>), AmbDim )
-            );
-    }
-
-    void ComputeEdgeQuotientSpaceSamplingHelper()
-    {
-        edge_quotient_space_sampling_helper
-            =
-            Frac<Real>(
-                std::exp2( Scalar::Quarter<Real> * static_cast<Real>( AmbDim * (AmbDim-1) ) ),
-                SOVolume<Real>(AmbDim)
-            );
-    }
-
-    void ComputeEdgeSpaceSamplingWeight() const
-    {
-        // Shifts all entries of x along y and writes the results to y.
-        // Mind that x and y are stored in SoA fashion, i.e., as matrix of size AmbDim x point_count.
-        
-        SquareMatrix_T cbar  (zero);
-        SquareMatrix_T gamma (zero);
-        
-        Real prod = one;
-        
-        const Real ww = Dot(w_,w_);
-        
-        const Real one_plus_ww = big_one + ww;
-        
-        for( Int i = 0; i < edge_count_; ++i )
-        {
-            Vector_T y_i ( y_, i );
             
-            const Real wy = Dot(w_,y_i);
-            
-            const Real factor = one_plus_ww + two * wy;
-            
-            // Multiplying by one_plus_ww_inv so that prod does not grow so quickly.
-            prod *= factor;
-            
-            const Real r_i = r_[i];
-            const Real r_over_rho_i = r_i / rho_[i];
-            const Real r_over_rho_i_squared = r_over_rho_i * r_over_rho_i;
-            
-            for( Int j = 0; j < AmbDim; ++j )
-            {
-                for( Int k = 0; k < AmbDim; ++k )
-                {
-                    const Real scratch = static_cast<Real>(j==k) - y_i[j] * y_i[k];
-                    
-                    gamma[j][k] += r_over_rho_i_squared * scratch;
-                    
-                    cbar [j][k] += r_i * scratch;
-                }
-            }
+            return det;
         }
-        
-        // We can simply absorb the factor std::pow(2/(one_minus_ww),d) into the function chi.
-        //  cbar *= static_cast<Real>(2)/(one_minus_ww);
-        
-        edge_space_sampling_weight =
-            edge_space_sampling_helper
-            *
-            Power( prod, static_cast<Int>(AmbDim-1) ) * Sqrt(gamma.Det()) / cbar.Det();
-    }
-
-    void ComputeEdgeQuotientSpaceSamplingWeight() const
-    {
-        edge_quotient_space_sampling_weight = EdgeSpaceSamplingWeight() * EdgeQuotientSpaceSamplingCorrection();
     }
@@ -103,38 +103,42 @@ private:
     {
         const Int fun_count = static_cast<Int>(F_list.size());
         
+        SampleScheduler scheduler ( Settings(), 0, sample_count, thread_count );
+        
+        WorkerSet workers = PrepareWorkers( thread_count );
+        
         ParallelDo(
             [&,this]( const Int thread )
             {
-                const Int k_begin = JobPointer( sample_count, thread_count, thread     );
-                const Int k_end   = JobPointer( sample_count, thread_count, thread + 1 );
-
-                // For every thread create a copy of the current Sampler object.
-                Sampler S ( EdgeLengths().data(), Rho().data(), EdgeCount(), Settings() );
+                // Every thread uses its own copy of the current Sampler object.
+                Sampler & S = workers[thread];
+                
+                RandomStreamCursor cursor = RandomStream();
                 
-                S.LoadRandomVariables( F_list );
+                S.LoadRandomVariablesCached( F_list );
                 
-                for( Int k = k_begin; k < k_end; ++k )
+                scheduler.Work( thread, [&]( const Int k_begin, const Int k_end )
                 {
-                    S.RandomizeInitialEdgeVectors();
-                    
-                    S.ComputeConformalClosure();
-                    
-                    if constexpr ( edge_space_flag )
-                    {
-                        K_edge_space[k] = S.EdgeSpaceSamplingWeight();
-                    }
-                    
-                    if constexpr ( quotient_space_flag )
-                    {
-                        K_quot_space[k] = S.EdgeQuotientSpaceSamplingWeight();
-                    }
-                    
-                    for( Int i = 0; i < fun_count; ++i )
-                    {
-                        sampled_values[k * fun_count + i] = S.EvaluateRandomVariable(i);
-                    }
-                }
+                    ClosedPolygonLoop<true,true>( S, cursor, k_begin, k_end,
+                        [&]( const Int k )
+                        {
+                            if constexpr ( edge_space_flag )
+                            {
+                                K_edge_space[k] = S.OutputEdgeSpaceSamplingWeight();
+                            }
+                            
+                            if constexpr ( quotient_space_flag )
+                            {
+                                K_quot_space[k] = S.OutputEdgeQuotientSpaceSamplingWeight();
+                            }
+                            
+                            for( Int i = 0; i < fun_count; ++i )
+                            {
+                                sampled_values[k * fun_count + i] = S.EvaluateRandomVariable(i);
+                            }
+                        }
+                    );
+                });
             },
             thread_count
         );
@@ -0,0 +1,76 @@
+private:
+
+    // Distributes the sample indices in [k_begin,k_end) over thread_count threads. Each thread calls
+    //
+    //     scheduler.Work( thread, job );
+    //
+    // and job( a, b ) is called for the ranges [a,b) assigned to this thread.
+    //
+    // - If Settings().use_dynamic_scheduling is not set, each thread gets the single range from JobPointer.
+    // - Otherwise, the threads pull chunks of Settings().scheduling_chunk_size samples from an atomic counter until all samples are done. So fast threads take over work from slow threads.
+    //
+    // In reproducible mode (Settings().use_seed), the output for sample k does not depend on the thread that computes it. There the chunk size is rounded up to a multiple of Settings().samples_per_stream, so that no chunk has to skip through its stream to its first sample.
+
+    class SampleScheduler
+    {
+    private:
+
+        const Int  k_begin;
+        const Int  k_end;
+        const Int  thread_count;
+        const bool dynamicQ;
+
+        Int chunk_size = 1;
+
+        std::atomic<Int> next;
+
+    public:
+
+        SampleScheduler(
+            const Setting_T & settings,
+            const Int k_begin_, const Int k_end_, const Int thread_count_
+        )
+        :   k_begin      ( k_begin_ )
+        ,   k_end        ( std::max( k_begin_, k_end_ ) )
+        ,   thread_count ( std::max( Int(1), thread_count_ ) )
+        ,   dynamicQ     ( settings.use_dynamic_scheduling )
+        ,   next         ( k_begin_ )
+        {
+            chunk_size = std::max( Int(1), settings.scheduling_chunk_size );
+
+            if( settings.use_seed )
+            {
+                const Int s = std::max( Int(1), settings.samples_per_stream );
+
+                chunk_size = s * ( (chunk_size + s - 1) / s );
+            }
+        }
+
+        template<typename Job_T>
+        void Work( const Int thread, Job_T && job )
+        {
+            if( !dynamicQ )
+            {
+                const Int n = k_end - k_begin;
+
+                job(
+                    k_begin + JobPointer( n, thread_count, thread     ),
+                    k_begin + JobPointer( n, thread_count, thread + 1 )
+                );
+
+                return;
+            }
+
+            while( true )
+            {
+                const Int a = next.fetch_add( chunk_size, std::memory_order_relaxed );
+
+                if( a >= k_end )
+                {
+                    break;
+                }
+
+                job( a, std::min( a + chunk_size, k_end ) );
+            }
+        }
+    };
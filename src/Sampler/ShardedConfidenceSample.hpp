@@ -0,0 +1,433 @@
+public:
+
+    /*!
+     * @brief Like `ConfidenceSample`, but distributes the sampling over `shard_count` local worker processes, each of which uses `thread_count` threads.
+     *
+     * The processes are forked from the calling process and talk to it over pipes. In each round, shard `s` gets the sample range `[N + s * chunk_size, N + (s + 1) * chunk_size)` (with `Settings().use_adaptive_chunks`, the chunk size of each round after the first one is predicted as in `ConfidenceSample`), samples it, and sends back its `CoBarS::ConfidenceState` in serialized form. The calling process merges the states in the order of the shards and applies the stopping rule of `ConfidenceSample` to the merged state. So in reproducible mode (`Settings().use_seed`), the result is the same as that of `ConfidenceSample` with chunk size `shard_count * chunk_size`, up to rounding. Otherwise, each worker process seeds its own pseudorandom number generators after forking.
+     *
+     * The merged state can be retrieved by `LastConfidenceState`. `Settings().retire_converged` is ignored, because the states of the shards are merged. Randomized quasi-Monte Carlo mode (`Settings().use_qmc`) is not supported.
+     *
+     * The worker processes are forked at the beginning, before this routine starts any threads. The calling process must not run any other threads at that time: A forked process contains only the forking thread, so a lock held by another thread (e.g., in the memory allocator) would never be released in the worker process.
+     *
+     * While this routine runs, `SIGPIPE` is blocked in the calling thread. So if a worker process dies, the failing write is reported as an error instead of terminating the calling process.
+     *
+     * The arguments are the same as for `ConfidenceSample`, except for `shard_count`. Only available on POSIX systems.
+     *
+     * @return The number of samples drawn, or 0 if the worker processes could not be started.
+     */
+
+    Int ShardedConfidenceSample(
+        const std::vector< std::shared_ptr<RandomVariable_T> > & F_list,
+        mptr<Real> sample_means,
+        mptr<Real> sample_variances,
+        mptr<Real> errors,
+        cptr<Real> radii,
+        const Int  max_sample_count,
+        const bool quotient_space_Q,
+        const Int  shard_count,
+        const Int  thread_count = 1,
+        const Real confidence = 0.95,
+        const Int  chunk_size = 1000000,
+        const bool relativeQ = false,
+        const bool verboseQ = true
+    ) const
+    {
+        ptic(ClassName()+"::ShardedConfidenceSample");
+
+        if( !ConfidenceArgumentsValidQ( confidence ) )
+        {
+            ptoc(ClassName()+"::ShardedConfidenceSample");
+
+            return 0;
+        }
+
+        if( Settings().use_qmc )
+        {
+            eprint(ClassName()+"::ShardedConfidenceSample: Randomized quasi-Monte Carlo mode (Settings().use_qmc) is not supported. Use ConfidenceSample. Aborting.");
+            
+            ptoc(ClassName()+"::ShardedConfidenceSample");
+            
+            return 0;
+        }
+        
+        if( verboseQ )
+        {
+            valprint( "shard_count     ", shard_count );
+
+            PrintConfidenceSampleInfo( F_list, thread_count, confidence, relativeQ );
+        }
+
+        const Int s_count = std::max( Int(1), shard_count );
+
+        SigPipeBlocker sigpipe_blocker;
+        
+        std::vector<Shard> shards;
+
+        for( Int s = 0; s < s_count; ++s )
+        {
+            Shard shard;
+
+            if( !StartShard( shard, shards, F_list, quotient_space_Q, thread_count ) )
+            {
+                eprint(ClassName()+"::ShardedConfidenceSample: Could not start worker process " + ToString(s) + ". Aborting." );
+
+                StopShards( shards );
+
+                ptoc(ClassName()+"::ShardedConfidenceSample");
+
+                return 0;
+            }
+
+            shards.push_back( shard );
+        }
+
+        ConfidenceState_T state = NewConfidenceState( F_list );
+
+        Int N = 0;
+
+        Real total_time = 0;
+
+        bool completed = false;
+
+        bool failedQ = false;
+
+        Int shard_chunk_size = chunk_size;
+
+        while( !completed )
+        {
+            Time start_time = Clock::now();
+
+            for( Int s = 0; s < s_count; ++s )
+            {
+                const std::uint64_t range [2] = {
+                    static_cast<std::uint64_t>( N + s       * shard_chunk_size ),
+                    static_cast<std::uint64_t>( N + (s + 1) * shard_chunk_size )
+                };
+
+                failedQ = failedQ || !WriteAll( shards[s].command_fd, &range[0], sizeof(range) );
+            }
+
+            // Merging in a fixed order makes the result independent of the order in which the shards finish.
+            for( Int s = 0; s < s_count; ++s )
+            {
+                std::uint64_t size = 0;
+
+                std::string message;
+
+                ConfidenceState_T shard_state;
+
+                failedQ = failedQ
+                    || !ReadAll( shards[s].result_fd, &size, sizeof(size) )
+                    || !ReadMessage( shards[s].result_fd, message, size )
+                    || !shard_state.Deserialize( message )
+                    || !state.Merge( shard_state );
+            }
+
+            if( failedQ )
+            {
+                eprint(ClassName()+"::ShardedConfidenceSample: Communication with a worker process failed. Aborting after " + ToString(N) + " samples.");
+
+                break;
+            }
+
+            Time stop_time = Clock::now();
+
+            total_time += Tools::Duration(start_time,stop_time);
+
+            N += s_count * shard_chunk_size;
+
+            if( N > max_sample_count )
+            {
+                wprint(ClassName()+"::ShardedConfidenceSample: Maximal number of samples reached. Sampling aborted after " + ToString(N) + " samples.");
+                break;
+            }
+
+            completed = ConfidenceReachedQ( state, radii, confidence, relativeQ, verboseQ, total_time );
+
+            if( Settings().use_adaptive_chunks && !completed )
+            {
+                const Real prediction = PredictedSampleCount( state, radii, confidence, relativeQ );
+
+                if( verboseQ )
+                {
+                    valprint("  predicted N", prediction );
+                }
+
+                const Int next_chunk_size = AdaptiveChunkSize( N, prediction, s_count * chunk_size, max_sample_count );
+
+                if( next_chunk_size <= 0 )
+                {
+                    wprint(ClassName()+"::ShardedConfidenceSample: Maximal number of samples reached. Sampling aborted after " + ToString(N) + " samples.");
+                    break;
+                }
+
+                shard_chunk_size = (next_chunk_size + s_count - 1) / s_count;
+            }
+        }
+
+        StopShards( shards );
+
+        if( state.SampleCount() > 1 )
+        {
+            WriteConfidenceResults( state, sample_means, sample_variances, errors, radii, confidence, relativeQ );
+        }
+
+        const Int sample_count = static_cast<Int>(state.SampleCount());
+
+        StoreConfidenceState( std::move(state) );
+
+        ptoc(ClassName()+"::ShardedConfidenceSample");
+
+        return sample_count;
+    }
+
+private:
+
+    struct Shard
+    {
+        pid_t pid        = -1;
+        int   command_fd = -1;
+        int   result_fd  = -1;
+    };
+
+    // Blocks SIGPIPE in the calling thread for its lifetime. Then writing to the pipe of a dead worker process fails with EPIPE instead of killing the process. A SIGPIPE that became pending meanwhile is consumed before the old signal mask is restored. The forked worker processes inherit the mask, so they notice a dead parent process in the same way.
+
+    class SigPipeBlocker
+    {
+    private:
+        
+        sigset_t sigpipe_set;
+        sigset_t old_mask;
+        
+        bool pendingQ = false;
+        
+    public:
+        
+        SigPipeBlocker()
+        {
+            sigemptyset( &sigpipe_set );
+            sigaddset( &sigpipe_set, SIGPIPE );
+            
+            pendingQ = SigPipePendingQ();
+            
+            (void)::pthread_sigmask( SIG_BLOCK, &sigpipe_set, &old_mask );
+        }
+        
+        ~SigPipeBlocker()
+        {
+            // A SIGPIPE that was pending before belongs to the caller.
+            if( !pendingQ && SigPipePendingQ() )
+            {
+                int signal_number = 0;
+                
+                (void)::sigwait( &sigpipe_set, &signal_number );
+            }
+            
+            (void)::pthread_sigmask( SIG_SETMASK, &old_mask, nullptr );
+        }
+        
+        SigPipeBlocker( const SigPipeBlocker & ) = delete;
+        
+        SigPipeBlocker & operator=( const SigPipeBlocker & ) = delete;
+        
+    private:
+        
+        static bool SigPipePendingQ()
+        {
+            sigset_t pending;
+            
+            sigemptyset( &pending );
+            
+            return (::sigpending( &pending ) == 0) && (sigismember( &pending, SIGPIPE ) == 1);
+        }
+    };
+    
+    // Starts a worker process. The ones in `running` were started before; the new process inherits their pipes and must close them. Otherwise, a worker process would not see the end of the file when the calling process closes a pipe of another one.
+
+    bool StartShard(
+        Shard & shard,
+        const std::vector<Shard> & running,
+        const std::vector< std::shared_ptr<RandomVariable_T> > & F_list,
+        const bool quotient_space_Q,
+        const Int  thread_count
+    ) const
+    {
+        int command_pipe [2];
+        int result_pipe  [2];
+
+        if( ::pipe( command_pipe ) != 0 )
+        {
+            return false;
+        }
+
+        if( ::pipe( result_pipe ) != 0 )
+        {
+            ::close( command_pipe[0] );
+            ::close( command_pipe[1] );
+
+            return false;
+        }
+
+        const pid_t pid = ::fork();
+
+        if( pid < 0 )
+        {
+            ::close( command_pipe[0] );
+            ::close( command_pipe[1] );
+            ::close( result_pipe[0] );
+            ::close( result_pipe[1] );
+
+            return false;
+        }
+
+        if( pid == 0 )
+        {
+            // Worker process.
+            ::close( command_pipe[1] );
+            ::close( result_pipe[0] );
+            
+            for( const Shard & other : running )
+            {
+                ::close( other.command_fd );
+                ::close( other.result_fd  );
+            }
+
+            ::_exit( RunShard( command_pipe[0], result_pipe[1], F_list, quotient_space_Q, thread_count ) );
+        }
+
+        ::close( command_pipe[0] );
+        ::close( result_pipe[1] );
+
+        shard.pid        = pid;
+        shard.command_fd = command_pipe[1];
+        shard.result_fd  = result_pipe[0];
+
+        return true;
+    }
+
+    // The loop of a worker process: Receive a range [a,b) of sample indices, sample it, and send back the state. An empty range ends the loop.
+
+    int RunShard(
+        const int command_fd,
+        const int result_fd,
+        const std::vector< std::shared_ptr<RandomVariable_T> > & F_list,
+        const bool quotient_space_Q,
+        const Int  thread_count
+    ) const
+    {
+        // The forked worker samplers share the states of their pseudorandom number generators with those of the other worker processes; we need fresh ones.
+        ReleaseWorkers();
+
+        while( true )
+        {
+            std::uint64_t range [2] = {0,0};
+
+            if( !ReadAll( command_fd, &range[0], sizeof(range) ) )
+            {
+                return 1;
+            }
+
+            if( range[0] >= range[1] )
+            {
+                return 0;
+            }
+
+            ConfidenceState_T state;
+
+            AccumulateConfidenceState(
+                F_list, state,
+                static_cast<Int>(range[0]), static_cast<Int>(range[1]),
+                quotient_space_Q, thread_count
+            );
+
+            const std::string message = state.Serialize();
+
+            const std::uint64_t size = message.size();
+
+            if( !WriteAll( result_fd, &size, sizeof(size) ) || !WriteAll( result_fd, message.data(), message.size() ) )
+            {
+                return 1;
+            }
+        }
+    }
+
+    static void StopShards( std::vector<Shard> & shards )
+    {
+        const std::uint64_t stop [2] = {0,0};
+
+        for( Shard & shard : shards )
+        {
+            (void)WriteAll( shard.command_fd, &stop[0], sizeof(stop) );
+
+            ::close( shard.command_fd );
+            ::close( shard.result_fd  );
+
+            int status = 0;
+
+            ::waitpid( shard.pid, &status, 0 );
+        }
+
+        shards.clear();
+    }
+
+    static bool ReadMessage( const int fd, std::string & message, const std::uint64_t size )
+    {
+        message.resize( static_cast<Size_T>(size) );
+
+        return ReadAll( fd, message.data(), message.size() );
+    }
+
+    // read and write may transfer less than requested or be interrupted by a signal, so we loop.
+
+    static bool ReadAll( const int fd, void * buffer, const Size_T byte_count )
+    {
+        char * a = static_cast<char *>(buffer);
+
+        Size_T done = 0;
+
+        while( done < byte_count )
+        {
+            const ssize_t r = ::read( fd, a + done, byte_count - done );
+
+            if( (r < 0) && (errno == EINTR) )
+            {
+                continue;
+            }
+            
+            if( r <= 0 )
+            {
+                return false;
+            }
+
+            done += static_cast<Size_T>(r);
+        }
+
+        return true;
+    }
+
+    static bool WriteAll( const int fd, const void * buffer, const Size_T byte_count )
+    {
+        const char * a = static_cast<const char *>(buffer);
+
+        Size_T done = 0;
+
+        while( done < byte_count )
+        {
+            const ssize_t w = ::write( fd, a + done, byte_count - done );
+
+            // With SIGPIPE blocked, a dead reader gives EPIPE here.
+            if( (w < 0) && (errno == EINTR) )
+            {
+                continue;
+            }
+            
+            if( w <= 0 )
+            {
+                return false;
+            }
+
+            done += static_cast<Size_T>(w);
+        }
+
+        return true;
+    }
@@ -0,0 +1,183 @@
+public:
+
+    using SampleBlock_T = SampleBlock<Real,Int>;
+
+    /*!
+     * @brief Samples `sample_count` random closed polygons and hands them over to `sink` in blocks of `block_size` samples, without ever storing all of them at once.
+     *
+     * The worker threads fill blocks of type `CoBarS::SampleBlock` with the vertex positions (only if `store_polygons_Q` is set), the sampling weights, and the values of the random variables in `F_list`. Each full block is put into a bounded queue; the calling thread takes the blocks out of it, calls `sink( block )`, and recycles the block. There are never more than `2 * thread_count` blocks in use, so the memory footprint does not depend on `sample_count`: if `sink` is slower than the sampling, the workers wait for free blocks. On the other hand, `sink` runs concurrently to the sampling.
+     *
+     * The blocks arrive in no particular order; use `block.Begin()` to find the index of the first sample in a block. In reproducible mode (`Settings().use_seed`), the samples do not depend on `thread_count` or `block_size`.
+     *
+     * @param F_list List of random variables to evaluate on each polygon.
+     *
+     * @param sample_count Total number of samples.
+     *
+     * @param sink A callable with signature `void( const SampleBlock_T & block )`. It is only called from the calling thread, so it needs not be thread-safe.
+     *
+     * @param thread_count Number of threads that do the sampling.
+     *
+     * @param block_size Maximal number of samples per block.
+     *
+     * @param store_polygons_Q Whether the blocks shall contain the vertex positions of the polygons.
+     */
+
+    template<typename Sink_T>
+    void StreamSample(
+        const std::vector<std::shared_ptr<RandomVariable_T>> & F_list,
+        const Int sample_count,
+        Sink_T && sink,
+        const Int thread_count = 1,
+        const Int block_size = 65536,
+        const bool store_polygons_Q = true
+    ) const
+    {
+        ptic(ClassName()+"::StreamSample");
+
+        if( store_polygons_Q )
+        {
+            streamSample<true>( F_list, sample_count, sink, thread_count, block_size );
+        }
+        else
+        {
+            streamSample<false>( F_list, sample_count, sink, thread_count, block_size );
+        }
+
+        ptoc(ClassName()+"::StreamSample");
+    }
+
+private:
+
+    template<bool store_polygons_Q, typename Sink_T>
+    void streamSample(
+        const std::vector<std::shared_ptr<RandomVariable_T>> & F_list,
+        const Int sample_count,
+        Sink_T & sink,
+        const Int thread_count,
+        const Int block_size
+    ) const
+    {
+        if( sample_count <= 0 )
+        {
+            return;
+        }
+
+        const Int fun_count   = static_cast<Int>(F_list.size());
+        const Int thread_cnt  = std::max( Int(1), thread_count );
+        const Int b_size      = std::max( Int(1), std::min( block_size, sample_count ) );
+        const Int block_count = (sample_count + b_size - 1) / b_size;
+
+        const Int vertex_size = store_polygons_Q ? (edge_count_ + 1) * AmbDim : Int(0);
+
+        // While thread_cnt blocks are being filled, thread_cnt more can wait for the sink.
+        const Size_T pool_size = static_cast<Size_T>( std::min( block_count, Int(2) * thread_cnt ) );
+
+        std::vector<std::unique_ptr<SampleBlock_T>> pool;
+
+        pool.reserve( pool_size );
+
+        BoundedQueue<SampleBlock_T *> free_blocks ( pool_size );
+        BoundedQueue<SampleBlock_T *> full_blocks ( pool_size );
+
+        for( Size_T i = 0; i < pool_size; ++i )
+        {
+            pool.push_back( std::make_unique<SampleBlock_T>( b_size, vertex_size, fun_count ) );
+
+            free_blocks.Push( pool.back().get() );
+        }
+
+        WorkerSet workers = PrepareWorkers( thread_cnt );
+
+        std::atomic<Int> next_block ( 0 );
+
+        // The workers run in the background, so that the calling thread can serve the sink.
+        std::thread producer ( [&,this]()
+        {
+            ParallelDo(
+                [&,this]( const Int thread )
+                {
+                    Sampler & S = workers[thread];
+
+                    RandomStreamCursor cursor = RandomStream();
+
+                    S.LoadRandomVariablesCached( F_list );
+
+                    while( true )
+                    {
+                        const Int b = next_block.fetch_add( 1, std::memory_order_relaxed );
+
+                        if( b >= block_count )
+                        {
+                            break;
+                        }
+
+                        SampleBlock_T * block = nullptr;
+
+                        if( !free_blocks.Pop( block ) )
+                        {
+                            break;
+                        }
+
+                        const Int k_begin = b * b_size;
+                        const Int k_end   = std::min( k_begin + b_size, sample_count );
+
+                        block->SetRange( k_begin, k_end - k_begin );
+
+                        mptr<Real> q       = block->VertexPositions();
+                        mptr<Real> K_edge  = block->EdgeSpaceSamplingWeights();
+                        mptr<Real> K_quot  = block->EdgeQuotientSpaceSamplingWeights();
+                        mptr<Real> values  = block->SampledValues();
+
+                        ClosedPolygonLoop<true,true>( S, cursor, k_begin, k_end,
+                            [&]( const Int k )
+                            {
+                                const Int l = k - k_begin;
+
+                                if constexpr ( store_polygons_Q )
+                                {
+                                    S.WriteVertexPositions( q, l );
+                                }
+
+                                K_edge[l] = S.OutputEdgeSpaceSamplingWeight();
+                                K_quot[l] = S.OutputEdgeQuotientSpaceSamplingWeight();
+
+                                for( Int i = 0; i < fun_count; ++i )
+                                {
+                                    values[l * fun_count + i] = S.EvaluateRandomVariable(i);
+                                }
+                            }
+                        );
+
+                        full_blocks.Push( block );
+                    }
+                },
+                thread_cnt
+            );
+        });
+
+        try
+        {
+            for( Int delivered = 0; delivered < block_count; ++delivered )
+            {
+                SampleBlock_T * block = nullptr;
+
+                full_blocks.Pop( block );
+
+                sink( std::as_const(*block) );
+
+                free_blocks.Push( block );
+            }
+        }
+        catch( ... )
+        {
+            // Release the workers waiting for free blocks before we leave.
+            free_blocks.Close();
+            full_blocks.Close();
+
+            producer.join();
+
+            throw;
+        }
+
+        producer.join();
+    }
@@ -0,0 +1,160 @@
+public:
+
+    /*!
+     * @brief Releases the per-thread samplers that the sampling routines keep between calls.
+     *
+     * The sampling routines (`CreateRandomClosedPolygons`, `Sample`, `BinnedSample`, `ConfidenceSample`, etc.) do not construct a new `Sampler` for each thread in each call. Instead, they use warm copies that are kept in this object, together with their buffers, their pseudorandom number generators, their clones of the random variables and, if `Settings().use_batch_engine` is set, their `CoBarS::BatchSampler`. These copies are released automatically when the edge lengths or rho change; call this routine to release them earlier.
+     *
+     * In randomized quasi-Monte Carlo mode (`Settings().use_qmc`), this also discards the scramblings of the Sobol sequences, so that the next sampling routine draws new ones.
+     *
+     * If a sampling routine is called while another one of the same instance is still running (from another thread, or from the `sink` of `StreamSample`), it does not use this cache but temporary copies, which are destroyed at its end. So concurrent calls are safe; they just do not profit from the cache. In randomized quasi-Monte Carlo mode without `Settings().use_seed`, such a call draws its own scramblings.
+     *
+     * While a sampling routine of this instance is running, this routine only prints a warning.
+     */
+
+    void ReleaseWorkers() const
+    {
+        if( workers_busy_.exchange( true, std::memory_order_acquire ) )
+        {
+            wprint( ClassName() + "::ReleaseWorkers: A sampling routine is running; the cached samplers are not released." );
+            
+            return;
+        }
+        
+        workers_.clear();
+        
+        qmc_.reset();
+        
+        workers_busy_.store( false, std::memory_order_release );
+    }
+
+private:
+
+    // The per-thread samplers of one call of a sampling routine; see PrepareWorkers.
+    //
+    // If no other sampling routine of the owner is running, these are the cached samplers in owner.workers_, and the owner's cache is locked until this object is destroyed. Otherwise, they are temporary ones. Either way, only the threads of this call touch them, and they do not touch any mutable member of the owner; in particular, each worker holds its own pointer to the scramblings of randomized quasi-Monte Carlo mode.
+    //
+    // The lock is a flag and not a std::mutex, because the sink of StreamSample may call a sampling routine from the thread that holds it.
+
+    class WorkerSet
+    {
+    private:
+        
+        const Sampler & owner;
+        
+        bool cachedQ = false;
+        
+        std::vector<Sampler> temporary;
+        
+        std::vector<Sampler> * list = nullptr;
+        
+    public:
+        
+        WorkerSet( const Sampler & owner_, const Int thread_count )
+        :   owner   ( owner_ )
+        ,   cachedQ ( !owner_.workers_busy_.exchange( true, std::memory_order_acquire ) )
+        ,   list    ( cachedQ ? &owner_.workers_ : &temporary )
+        {
+            try
+            {
+                Prepare( thread_count );
+            }
+            catch( ... )
+            {
+                Unlock();
+                
+                throw;
+            }
+        }
+        
+        ~WorkerSet()
+        {
+            Unlock();
+        }
+        
+        WorkerSet( const WorkerSet & other ) = delete;
+        
+        WorkerSet & operator=( const WorkerSet & other ) = delete;
+        
+        Sampler & operator[]( const Int thread )
+        {
+            return (*list)[static_cast<Size_T>(thread)];
+        }
+        
+    private:
+        
+        void Prepare( const Int thread_count )
+        {
+            std::shared_ptr<const ScrambledSobol> qmc;
+            
+            if( owner.Settings().use_qmc )
+            {
+                // A temporary set must not read owner.qmc_, because the set that owns the cache may replace it.
+                qmc = owner.QMC( cachedQ ? owner.qmc_ : nullptr );
+                
+                if( cachedQ )
+                {
+                    owner.qmc_ = qmc;
+                }
+            }
+            
+            const Size_T n = static_cast<Size_T>( std::max( thread_count, Int(1) ) );
+            
+            if( list->size() < n )
+            {
+                list->reserve( n );
+                
+                while( list->size() < n )
+                {
+                    list->emplace_back( owner.EdgeLengths().data(), owner.Rho().data(), owner.EdgeCount(), owner.Settings() );
+                }
+            }
+            
+            for( Sampler & S : *list )
+            {
+                S.qmc_ = qmc;
+            }
+        }
+        
+        void Unlock()
+        {
+            if( cachedQ )
+            {
+                owner.workers_busy_.store( false, std::memory_order_release );
+            }
+        }
+        
+    }; // class WorkerSet
+    
+    // Provides a sampler for each of the threads 0, ..., thread_count - 1, for use in ParallelDo. Keep the result alive until the threads are done.
+
+    WorkerSet PrepareWorkers( const Int thread_count ) const
+    {
+        return WorkerSet( *this, thread_count );
+    }
+
+    // Like LoadRandomVariables, but only clones the random variables if F_list differs from the list of the last call.
+
+    void LoadRandomVariablesCached( const std::vector<std::shared_ptr<RandomVariable_T>> & F_list ) const
+    {
+        if( F_list != F_list_origin_ )
+        {
+            LoadRandomVariables( F_list );
+
+            F_list_origin_ = F_list;
+        }
+    }
+
+    // The BatchSampler of this instance; created on first use.
+
+    BatchSampler_T & BatchEngine() const
+    {
+        if( !batch_ )
+        {
+            batch_ = std::make_unique<BatchSampler_T>(
+                EdgeLengths().data(), Rho().data(), EdgeCount(), Settings()
+            );
+        }
+
+        return *batch_;
+    }
@@ -80,6 +80,18 @@ namespace CoBarS
         
         virtual Real EdgeQuotientSpaceSamplingWeight() const = 0;
         
+        /*!
+         * @brief Returns the natural logarithm of `EdgeSpaceSamplingWeight()`. It is computed directly, so it is finite even for polygons with so many edges that the weight itself over- or underflows.
+         */
+        
+        virtual Real EdgeSpaceSamplingLogWeight() const = 0;
+        
+        /*!
+         * @brief Returns the natural logarithm of `EdgeQuotientSpaceSamplingWeight()`. It is computed directly, so it is finite even for polygons with so many edges that the weight itself over- or underflows.
+         */
+        
+        virtual Real EdgeQuotientSpaceSamplingLogWeight() const = 0;
+        
 //        /*!
 //         * @brief Returns the `i`-th coordinate of the `k`-th edge vector of the open polygon. This routine is slow; try to avoid it.
 //         */
@@ -277,6 +289,12 @@ namespace CoBarS
         
         virtual Real ErrorEstimator() const = 0;
         
+        /*!
+         * @brief Returns whether the last call to `Optimize` succeeded, i.e., whether `ErrorEstimator()` dropped below `Settings().tolerance`.
+         */
+        
+        virtual bool SucceededQ() const = 0;
+        
         /*!
          * @brief Returns the number of iterations the last call to `Optimize` needed.
          */
@@ -574,6 +592,8 @@ namespace CoBarS
          * @param mom_count The number of moments to compute.
          *
          * @param random_vars The list of random variables to sample.
+         *
+         * In randomized quasi-Monte Carlo mode (`Settings().use_qmc`), sample `k` belongs to the scrambled Sobol sequence `k % Settings().qmc_replicate_count`. Error estimates can be obtained by calling this routine with `sample_count` a multiple of `qmc_replicate_count` and comparing the results of independent scramblings, e.g., with different `Settings().seed`.
          */
         
         virtual void BinnedSample(
@@ -652,12 +672,14 @@ namespace CoBarS
          *
          * @param confidence_level The confidence level to use to compute the confidence intervals.
          *
-         * @param chunk_size How many random polygons ought to be sampled at once per thread. Larger values need more memory, byt the also reduce the overhead a bit.
+         * @param chunk_size How many random polygons ought to be sampled at once per thread. Larger values need more memory, byt the also reduce the overhead a bit. If `Settings().use_adaptive_chunks` is set, this is only the size of the first chunk; the following chunks are sized so as to end just beyond the predicted number of samples needed.
          *
          * @param relativeQ Whether the `radii` are to be interpreted as relative to the (unknown) mean (`relativeQ == true`) or not (`relativeQ == false`).
          *
          * @param verboseQ Whether to print some intermediate information (`verboseQ == true`) or not (`verboseQ == false`).
          *
+         * In randomized quasi-Monte Carlo mode (`Settings().use_qmc`), the samples are points of `Settings().qmc_replicate_count` independently scrambled Sobol sequences. The means are then the averages of the means of the scramblings, and the radii of the confidence intervals are computed from their spread with Student's t-distribution.
+         *
          * @return The total number of samples needed.
          */
         
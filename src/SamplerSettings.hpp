@@ -5,6 +5,46 @@ namespace CoBarS
     template<typename Sampler_T> class RandomVariable;
 
     
+    /*!
+     * @brief The iterations that `CoBarS::Sampler` can use to compute the conformal barycenter; see `SamplerSettings::solver_strategy`.
+     *
+     *  - `Newton`: Regularized Newton steps with Armijo backtracking on the potential. This is the default.
+     *  - `Newton_Residual`: Regularized Newton steps with Armijo backtracking on the squared residual.
+     *  - `Chebyshev`: Third-order Chebyshev steps (the Halley-type correction of the Newton step by the third derivative of the potential) with Armijo backtracking on the potential.
+     *  - `TrustRegion`: Dogleg steps between the steepest descent step and the Newton step in a trust region of radius adapted to the reduction of the potential.
+     *  - `Gradient_Hyperbolic`: Steepest descent on the potential with Armijo backtracking.
+     *  - `Gradient_Planar`: Steepest descent with twice the gradient; without line search, this is the algorithm of Abikoff and Ye.
+     */
+    
+    enum class SolverStrategy : int
+    {
+        Newton              = 0,
+        Newton_Residual     = 1,
+        Chebyshev           = 2,
+        TrustRegion         = 3,
+        Gradient_Hyperbolic = 4,
+        Gradient_Planar     = 5
+    };
+    
+    /*!
+     * @brief Returns the name of `strategy` as it is spelled in `CoBarS::SolverStrategy`.
+     */
+    
+    inline std::string SolverStrategyName( const SolverStrategy strategy )
+    {
+        switch( strategy )
+        {
+            case SolverStrategy::Newton:              return "Newton";
+            case SolverStrategy::Newton_Residual:     return "Newton_Residual";
+            case SolverStrategy::Chebyshev:           return "Chebyshev";
+            case SolverStrategy::TrustRegion:         return "TrustRegion";
+            case SolverStrategy::Gradient_Hyperbolic: return "Gradient_Hyperbolic";
+            case SolverStrategy::Gradient_Planar:     return "Gradient_Planar";
+        }
+        
+        return "Unknown";
+    }
+    
     /*!
      * @brief A struct to carry the options for `CoBarS::SamplerBase` and `CoBarS::Sampler`.
      */
@@ -24,6 +64,43 @@ namespace CoBarS
         
         bool use_linesearch       = true;
         
+        // The iteration used for the conformal closure. CoBarS::BatchSampler implements only SolverStrategy::Newton; with any other strategy, the sampling routines close the polygons one by one and ignore use_batch_engine.
+        SolverStrategy solver_strategy = SolverStrategy::Newton;
+        
+        // The initial radius of the trust region of SolverStrategy::TrustRegion, measured in the tangent space at the current iterate.
+        Real trust_region_radius  = 1;
+        
+        // Close several polygons at once with CoBarS::BatchSampler in the sampling routines.
+        bool use_batch_engine     = false;
+        
+        // Reproducible mode: If use_seed is set, the sampling routines do not seed their pseudorandom number generators from std::random_device. Instead, sample k draws its random numbers from stream k / samples_per_stream of seed. So the results do not depend on thread_count.
+        bool          use_seed           = false;
+        std::uint64_t seed               = 0;
+        Int           samples_per_stream = 1024;
+        
+        // Let the threads of the sampling routines pull chunks of scheduling_chunk_size samples from a shared counter instead of splitting the samples evenly in advance.
+        bool use_dynamic_scheduling = false;
+        Int  scheduling_chunk_size  = 1024;
+        
+        // Let each thread of BinnedSample store only the bins that it hits, instead of a full copy of all bins. Use this for histograms with very many bins.
+        bool use_sparse_bins = false;
+        
+        // Let ConfidenceSample choose the size of each chunk after the first one from the predicted number of samples that are still needed, instead of using chunk_size throughout.
+        bool use_adaptive_chunks = false;
+        
+        // Let ConfidenceSample stop evaluating the random variables whose confidence intervals are already small enough; their estimates are frozen. ConfidenceState::SampleCount(i) tells how many samples each random variable got.
+        bool retire_converged    = false;
+        
+        // Randomized quasi-Monte Carlo: If use_qmc is set, the initial edge vectors of sample k are computed from point k / qmc_replicate_count of the scrambled Sobol sequence number k % qmc_replicate_count (see CoBarS::ScrambledSobol) instead of being drawn from the pseudorandom number generators. The scramblings are derived from seed if use_seed is set, otherwise from std::random_device; they are kept until Sampler::ReleaseWorkers is called, so repeated calls of a sampling routine give the same samples. ConfidenceSample then estimates its errors from the spread between the qmc_replicate_count scramblings.
+        bool use_qmc             = false;
+        Int  qmc_replicate_count = 16;
+        
+        // Let the routines that write the sampling weights into arrays (CreateRandomClosedPolygons, ComputeConformalClosures, CreateRandomCentralizedPointClouds_Detailed and their compact variants, Sample, StreamSample, and Replay) write their natural logarithms instead. The weights of polygons with many thousands of edges over- or underflow, but their logarithms do not. BinnedSample and ConfidenceSample need the weights themselves; they ignore this setting.
+        bool log_weights         = false;
+        
+        // Split the loops over the edges of each single polygon across polygon_thread_count threads (e.g., the assembly of the Newton system, the line search, the vertex positions, and the sampling weights). This is meant for polygons with 10^5 edges and more, of which one needs only a few samples; then call the sampling routines with thread_count = 1. Polygons with fewer than 16384 edges per thread use fewer threads. The results agree with the single-threaded ones up to roundoff. The random edge vectors are still drawn on one thread, and CoBarS::BatchSampler ignores this setting.
+        Int  polygon_thread_count = 1;
+        
         SamplerSettings() {}
         
         ~SamplerSettings() = default;
@@ -37,18 +114,48 @@ namespace CoBarS
         ,   Armijo_shrink_factor(other.Armijo_shrink_factor)
         ,   max_backtrackings(other.max_backtrackings)
         ,   use_linesearch(other.use_linesearch)
+        ,   solver_strategy(other.solver_strategy)
+        ,   trust_region_radius(other.trust_region_radius)
+        ,   use_batch_engine(other.use_batch_engine)
+        ,   use_seed(other.use_seed)
+        ,   seed(other.seed)
+        ,   samples_per_stream(other.samples_per_stream)
+        ,   use_dynamic_scheduling(other.use_dynamic_scheduling)
+        ,   scheduling_chunk_size(other.scheduling_chunk_size)
+        ,   use_sparse_bins(other.use_sparse_bins)
+        ,   use_adaptive_chunks(other.use_adaptive_chunks)
+        ,   retire_converged(other.retire_converged)
+        ,   use_qmc(other.use_qmc)
+        ,   qmc_replicate_count(other.qmc_replicate_count)
+        ,   log_weights(other.log_weights)
+        ,   polygon_thread_count(other.polygon_thread_count)
         {}
         
         void PrintStats() const
         {
-            valprint( "tolerance           ", tolerance           , 16 );
-            valprint( "give_up_tolerance   ", give_up_tolerance   , 16 );
-            valprint( "regularization      ", regularization      , 16 );
-            valprint( "max_iter            ", max_iter            , 16 );
-            valprint( "Armijo_slope_factor ", Armijo_slope_factor , 16 );
-            valprint( "Armijo_shrink_factor", Armijo_shrink_factor, 16 );
-            valprint( "max_backtrackings   ", max_backtrackings   , 16 );
-            valprint( "use_linesearch      ", use_linesearch      , 16 );
+            valprint( "tolerance             ", tolerance             , 16 );
+            valprint( "give_up_tolerance     ", give_up_tolerance     , 16 );
+            valprint( "regularization        ", regularization        , 16 );
+            valprint( "max_iter              ", max_iter              , 16 );
+            valprint( "Armijo_slope_factor   ", Armijo_slope_factor   , 16 );
+            valprint( "Armijo_shrink_factor  ", Armijo_shrink_factor  , 16 );
+            valprint( "max_backtrackings     ", max_backtrackings     , 16 );
+            valprint( "use_linesearch        ", use_linesearch        , 16 );
+            valprint( "solver_strategy       ", SolverStrategyName(solver_strategy), 16 );
+            valprint( "trust_region_radius   ", trust_region_radius   , 16 );
+            valprint( "use_batch_engine      ", use_batch_engine      , 16 );
+            valprint( "use_seed              ", use_seed              , 16 );
+            valprint( "seed                  ", seed                  , 16 );
+            valprint( "samples_per_stream    ", samples_per_stream    , 16 );
+            valprint( "use_dynamic_scheduling", use_dynamic_scheduling, 16 );
+            valprint( "scheduling_chunk_size ", scheduling_chunk_size , 16 );
+            valprint( "use_sparse_bins       ", use_sparse_bins       , 16 );
+            valprint( "use_adaptive_chunks   ", use_adaptive_chunks   , 16 );
+            valprint( "retire_converged      ", retire_converged      , 16 );
+            valprint( "use_qmc               ", use_qmc               , 16 );
+            valprint( "qmc_replicate_count   ", qmc_replicate_count   , 16 );
+            valprint( "log_weights           ", log_weights           , 16 );
+            valprint( "polygon_thread_count  ", polygon_thread_count  , 16 );
         }
     };
     
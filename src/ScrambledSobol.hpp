@@ -0,0 +1,274 @@
+#pragma once
+
+namespace CoBarS
+{
+    /*!
+     * @class ScrambledSobol
+     *
+     * @brief Randomly scrambled Sobol points for randomized quasi-Monte Carlo (RQMC) sampling.
+     *
+     * Holds `ReplicateCount()` independent scramblings of the Sobol sequence in dimension `Dimension()`. Point `j` of replicate `r` is computed directly from `j` (no state is carried from one point to the next), so any thread can compute any point.
+     *
+     * The direction numbers are those of [Joe and Kuo - _Constructing Sobol sequences with better two-dimensional projections_ (2008)](https://doi.org/10.1137/070709359) (file `new-joe-kuo-6.21201`) for the first `SobolDimensionCount` coordinates. Each coordinate is randomized by a nested uniform scramble in the hash-based form of [Burley - _Practical Hash-based Owen Scrambling_ (2020)](https://jcgt.org/published/0009/04/01/), with its own seed for each replicate. So each point of each replicate is uniformly distributed in the unit cube, and the replicates are independent; this is what allows for error estimates. Coordinates beyond `SobolDimensionCount` are filled with pseudorandom numbers from a hash of seed, replicate, point index, and coordinate.
+     *
+     * Points are given with 32 bits per coordinate, so each replicate has at most 2^32 distinct points.
+     */
+
+    class ScrambledSobol
+    {
+    public:
+
+        static constexpr std::uint32_t SobolDimensionCount = 53;
+
+        static constexpr int BitCount = 32;
+
+    private:
+
+        struct DirectionNumbers
+        {
+            std::uint32_t degree;
+            std::uint32_t coefficients;
+            std::uint32_t m [8];
+        };
+
+        // Joe-Kuo direction numbers for the coordinates 1,...,SobolDimensionCount-1. Coordinate 0 is the van der Corput sequence.
+        static constexpr DirectionNumbers joe_kuo [SobolDimensionCount - 1] = {
+            {  1,   0, {   1 } },
+            {  2,   1, {   1,   3 } },
+            {  3,   1, {   1,   3,   1 } },
+            {  3,   2, {   1,   1,   1 } },
+            {  4,   1, {   1,   1,   3,   3 } },
+            {  4,   4, {   1,   3,   5,  13 } },
+            {  5,   2, {   1,   1,   5,   5,  17 } },
+            {  5,   4, {   1,   1,   5,   5,   5 } },
+            {  5,   7, {   1,   1,   7,  11,  19 } },
+            {  5,  11, {   1,   1,   5,   1,   1 } },
+            {  5,  13, {   1,   1,   1,   3,  11 } },
+            {  5,  14, {   1,   3,   5,   5,  31 } },
+            {  6,   1, {   1,   3,   3,   9,   7,  49 } },
+            {  6,  13, {   1,   1,   1,  15,  21,  21 } },
+            {  6,  16, {   1,   3,   1,  13,  27,  49 } },
+            {  6,  19, {   1,   1,   1,  15,   7,   5 } },
+            {  6,  22, {   1,   3,   1,  15,  13,  25 } },
+            {  6,  25, {   1,   1,   5,   5,  19,  61 } },
+            {  7,   1, {   1,   3,   7,  11,  23,  15, 103 } },
+            {  7,   4, {   1,   3,   7,  13,  13,  15,  69 } },
+            {  7,   7, {   1,   1,   3,  13,   7,  35,  63 } },
+            {  7,   8, {   1,   3,   5,   9,   1,  25,  53 } },
+            {  7,  14, {   1,   3,   1,  13,   9,  35, 107 } },
+            {  7,  19, {   1,   3,   1,   5,  27,  61,  31 } },
+            {  7,  21, {   1,   1,   5,  11,  19,  41,  61 } },
+            {  7,  28, {   1,   3,   5,   3,   3,  13,  69 } },
+            {  7,  31, {   1,   1,   7,  13,   1,  19,   1 } },
+            {  7,  32, {   1,   3,   7,   5,  13,  19,  59 } },
+            {  7,  37, {   1,   1,   3,   9,  25,  29,  41 } },
+            {  7,  41, {   1,   3,   5,  13,  23,   1,  55 } },
+            {  7,  42, {   1,   3,   7,   3,  13,  59,  17 } },
+            {  7,  50, {   1,   3,   1,   3,   5,  53,  69 } },
+            {  7,  55, {   1,   1,   5,   5,  23,  33,  13 } },
+            {  7,  56, {   1,   1,   7,   7,   1,  61, 123 } },
+            {  7,  59, {   1,   1,   7,   9,  13,  61,  49 } },
+            {  7,  62, {   1,   3,   3,   5,   3,  55,  33 } },
+            {  8,  14, {   1,   3,   1,  15,  31,  13,  49, 245 } },
+            {  8,  21, {   1,   3,   5,  15,  31,  59,  63,  97 } },
+            {  8,  22, {   1,   3,   1,  11,  11,  11,  77, 249 } },
+            {  8,  38, {   1,   3,   1,  11,  27,  43,  71,   9 } },
+            {  8,  47, {   1,   1,   7,  15,  21,  11,  81,  45 } },
+            {  8,  49, {   1,   3,   7,   3,  25,  31,  65,  79 } },
+            {  8,  50, {   1,   3,   1,   1,  19,  11,   3, 205 } },
+            {  8,  52, {   1,   1,   5,   9,  19,  21,  29, 157 } },
+            {  8,  56, {   1,   3,   7,  11,   1,  33,  89, 185 } },
+            {  8,  67, {   1,   3,   3,   3,  15,   9,  79,  71 } },
+            {  8,  70, {   1,   3,   7,  11,  15,  39, 119,  27 } },
+            {  8,  84, {   1,   1,   3,   1,  11,  31,  97, 225 } },
+            {  8,  97, {   1,   1,   1,   3,  23,  43,  57, 177 } },
+            {  8, 103, {   1,   3,   7,   7,  17,  17,  37,  71 } },
+            {  8, 115, {   1,   3,   1,   5,  27,  63, 123, 213 } },
+            {  8, 122, {   1,   1,   3,   5,  11,  43,  53, 133 } }
+        };
+
+        std::uint32_t dimension       = 0;
+        std::uint32_t replicate_count = 1;
+        std::uint64_t seed            = 0;
+
+        // BitCount direction numbers per Sobol coordinate.
+        std::vector<std::uint32_t> V;
+
+        // One scrambling seed per replicate and coordinate.
+        std::vector<std::uint32_t> scramble_seeds;
+
+    public:
+
+        ScrambledSobol() = default;
+
+        /*!
+         * @brief Sets up `replicate_count` independent scramblings of the Sobol sequence in dimension `dimension_`, derived from `seed_`.
+         */
+
+        ScrambledSobol( const std::uint32_t dimension_, const std::uint32_t replicate_count_, const std::uint64_t seed_ )
+        :   dimension       ( dimension_ )
+        ,   replicate_count ( std::max( std::uint32_t(1), replicate_count_ ) )
+        ,   seed            ( seed_ )
+        {
+            const std::uint32_t sobol_dim = std::min( dimension, SobolDimensionCount );
+
+            V.resize( static_cast<Size_T>(sobol_dim) * BitCount );
+
+            for( std::uint32_t i = 0; i < sobol_dim; ++i )
+            {
+                std::uint32_t * v = &V[static_cast<Size_T>(i) * BitCount];
+
+                if( i == 0 )
+                {
+                    for( int b = 0; b < BitCount; ++b )
+                    {
+                        v[b] = std::uint32_t(1) << (BitCount - 1 - b);
+                    }
+
+                    continue;
+                }
+
+                const DirectionNumbers & d = joe_kuo[i - 1];
+
+                const int s = static_cast<int>(d.degree);
+
+                for( int b = 0; b < std::min( s, BitCount ); ++b )
+                {
+                    v[b] = d.m[b] << (BitCount - 1 - b);
+                }
+
+                // The recurrence of the primitive polynomial x^s + a_1 x^(s-1) + ... + a_(s-1) x + 1.
+                for( int b = s; b < BitCount; ++b )
+                {
+                    v[b] = v[b - s] ^ (v[b - s] >> s);
+
+                    for( int k = 1; k < s; ++k )
+                    {
+                        if( (d.coefficients >> (s - 1 - k)) & std::uint32_t(1) )
+                        {
+                            v[b] ^= v[b - k];
+                        }
+                    }
+                }
+            }
+
+            scramble_seeds.resize( static_cast<Size_T>(replicate_count) * dimension );
+
+            for( std::uint32_t r = 0; r < replicate_count; ++r )
+            {
+                for( std::uint32_t i = 0; i < dimension; ++i )
+                {
+                    scramble_seeds[static_cast<Size_T>(r) * dimension + i] = static_cast<std::uint32_t>(
+                        Mix( seed ^ Mix( (std::uint64_t(r) << 32) | i ) ) >> 32
+                    );
+                }
+            }
+        }
+
+        std::uint32_t Dimension() const
+        {
+            return dimension;
+        }
+
+        std::uint32_t ReplicateCount() const
+        {
+            return replicate_count;
+        }
+
+        std::uint64_t Seed() const
+        {
+            return seed;
+        }
+
+        /*!
+         * @brief Writes the `Dimension()` coordinates of point `j` of replicate `r` to `u`. All coordinates lie in the open interval (0,1).
+         */
+
+        template<typename Real>
+        void Point( const std::uint32_t r, const std::uint64_t j, mptr<Real> u ) const
+        {
+            constexpr Real scale = Real(1) / static_cast<Real>( std::uint64_t(1) << BitCount );
+
+            const std::uint32_t index = static_cast<std::uint32_t>(j);
+
+            cptr<std::uint32_t> seeds = &scramble_seeds[static_cast<Size_T>(r) * dimension];
+
+            const std::uint32_t sobol_dim = std::min( dimension, SobolDimensionCount );
+
+            for( std::uint32_t i = 0; i < sobol_dim; ++i )
+            {
+                cptr<std::uint32_t> v = &V[static_cast<Size_T>(i) * BitCount];
+
+                std::uint32_t x = 0;
+
+                for( std::uint32_t a = index, b = 0; a != 0; a >>= 1, ++b )
+                {
+                    x ^= (a & std::uint32_t(1)) ? v[b] : std::uint32_t(0);
+                }
+
+                u[i] = scale * ( static_cast<Real>( NestedUniformScramble( x, seeds[i] ) ) + Real(0.5) );
+            }
+
+            for( std::uint32_t i = sobol_dim; i < dimension; ++i )
+            {
+                const std::uint32_t x = static_cast<std::uint32_t>(
+                    Mix( Mix( j ^ (std::uint64_t(seeds[i]) << 32) ) + i ) >> 32
+                );
+
+                u[i] = scale * ( static_cast<Real>(x) + Real(0.5) );
+            }
+        }
+
+        /*!
+         * @brief The RQMC sample with index `k` is point `k / ReplicateCount()` of replicate `k % ReplicateCount()`. So every consecutive range of `ReplicateCount()` samples contains one point of every replicate.
+         */
+
+        template<typename Real, typename Int>
+        void Sample( const Int k, mptr<Real> u ) const
+        {
+            const std::uint64_t K = static_cast<std::uint64_t>(k);
+
+            Point( static_cast<std::uint32_t>(K % replicate_count), K / replicate_count, u );
+        }
+
+    private:
+
+        // The finalizer of splitmix64.
+        static std::uint64_t Mix( std::uint64_t z )
+        {
+            z += std::uint64_t(0x9e3779b97f4a7c15);
+            z = (z ^ (z >> 30)) * std::uint64_t(0xbf58476d1ce4e5b9);
+            z = (z ^ (z >> 27)) * std::uint64_t(0x94d049bb133111eb);
+            return z ^ (z >> 31);
+        }
+
+        static std::uint32_t ReverseBits( std::uint32_t x )
+        {
+            x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+            x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+            x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+            x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+            return (x >> 16) | (x << 16);
+        }
+
+        // Each bit of the result of the Laine-Karras permutation depends only on the same and on lower bits of x. So in bit-reversed order, it flips each digit depending only on the higher digits, which is a nested (Owen) scramble.
+        static std::uint32_t NestedUniformScramble( std::uint32_t x, const std::uint32_t s )
+        {
+            x = ReverseBits( x );
+            x += s;
+            x ^= x * 0x6c50b47cu;
+            x ^= x * 0xb82f1e52u;
+            x ^= x * 0xc7afe638u;
+            x ^= x * 0x8d22f6e6u;
+            return ReverseBits( x );
+        }
+
+    public:
+
+        static std::string ClassName()
+        {
+            return "ScrambledSobol";
+        }
+    };
+
+} // namespace CoBarS
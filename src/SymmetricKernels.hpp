@@ -0,0 +1,182 @@
+#pragma once
+
+namespace CoBarS
+{
+    // Closed-form linear algebra for symmetric matrices in dimensions 2, 3, and 4. The matrices can be of any type `Matrix_T` that allows access `A[j][k]`; only the upper triangle `j <= k` is read, as with `Tiny::SelfAdjointMatrix`. Everything is written out explicitly and free of branches and library calls (except `std::sqrt` and the trigonometric functions for the 3 x 3 eigenvalue), so that it can be inlined into the loops of `CoBarS::Sampler` and `CoBarS::BatchSampler`.
+
+/*!
+ * @brief Whether the closed-form kernels below are available in dimension `d`.
+ */
+
+    template<int d>
+    constexpr bool SymmetricKernelsQ = (d >= 2) && (d <= 4);
+
+/*!
+ * @brief Returns the determinant of the symmetric `d` x `d` matrix `A` for `d` = 2, 3, 4.
+ */
+
+    template<int d, typename Real, typename Matrix_T>
+    Real SymmetricDet( const Matrix_T & A )
+    {
+        static_assert( SymmetricKernelsQ<d>, "" );
+
+        if constexpr ( d == 2 )
+        {
+            return A[0][0] * A[1][1] - A[0][1] * A[0][1];
+        }
+        else if constexpr ( d == 3 )
+        {
+            return
+                  A[0][0] * ( A[1][1] * A[2][2] - A[1][2] * A[1][2] )
+                - A[0][1] * ( A[0][1] * A[2][2] - A[1][2] * A[0][2] )
+                + A[0][2] * ( A[0][1] * A[1][2] - A[1][1] * A[0][2] );
+        }
+        else
+        {
+            // Laplace expansion along the first two rows; s_* are the 2 x 2 minors of rows 0,1 and c_* are the complementary ones of rows 2,3.
+            const Real s_0 = A[0][0] * A[1][1] - A[0][1] * A[0][1];
+            const Real s_1 = A[0][0] * A[1][2] - A[0][1] * A[0][2];
+            const Real s_2 = A[0][0] * A[1][3] - A[0][1] * A[0][3];
+            const Real s_3 = A[0][1] * A[1][2] - A[1][1] * A[0][2];
+            const Real s_4 = A[0][1] * A[1][3] - A[1][1] * A[0][3];
+            const Real s_5 = A[0][2] * A[1][3] - A[1][2] * A[0][3];
+
+            const Real c_5 = A[2][2] * A[3][3] - A[2][3] * A[2][3];
+            const Real c_4 = A[1][2] * A[3][3] - A[1][3] * A[2][3];
+            const Real c_3 = A[1][2] * A[2][3] - A[1][3] * A[2][2];
+            const Real c_2 = A[0][2] * A[3][3] - A[0][3] * A[2][3];
+            const Real c_1 = A[0][2] * A[2][3] - A[0][3] * A[2][2];
+            const Real c_0 = A[0][2] * A[1][3] - A[0][3] * A[1][2];
+
+            return s_0 * c_5 - s_1 * c_4 + s_2 * c_3 + s_3 * c_2 - s_4 * c_1 + s_5 * c_0;
+        }
+    }
+
+/*!
+ * @brief Solves `A x = b` for the symmetric, invertible `d` x `d` matrix `A` and `d` = 2, 3, 4 by the explicit inverse (adjugate divided by determinant).
+ *
+ * `b` and `x` may be of any vector type that allows access `b[j]`; they must not overlap.
+ */
+
+    template<int d, typename Real, typename Matrix_T, typename Vector_T>
+    void SymmetricSolve( const Matrix_T & A, const Vector_T & b, Vector_T & x )
+    {
+        static_assert( SymmetricKernelsQ<d>, "" );
+
+        if constexpr ( d == 2 )
+        {
+            const Real det_inv = Real(1) / ( A[0][0] * A[1][1] - A[0][1] * A[0][1] );
+
+            x[0] = ( A[1][1] * b[0] - A[0][1] * b[1] ) * det_inv;
+            x[1] = ( A[0][0] * b[1] - A[0][1] * b[0] ) * det_inv;
+        }
+        else if constexpr ( d == 3 )
+        {
+            // The adjugate of a symmetric matrix is symmetric.
+            const Real B_00 = A[1][1] * A[2][2] - A[1][2] * A[1][2];
+            const Real B_01 = A[0][2] * A[1][2] - A[0][1] * A[2][2];
+            const Real B_02 = A[0][1] * A[1][2] - A[0][2] * A[1][1];
+            const Real B_11 = A[0][0] * A[2][2] - A[0][2] * A[0][2];
+            const Real B_12 = A[0][1] * A[0][2] - A[0][0] * A[1][2];
+            const Real B_22 = A[0][0] * A[1][1] - A[0][1] * A[0][1];
+
+            const Real det_inv = Real(1) / ( A[0][0] * B_00 + A[0][1] * B_01 + A[0][2] * B_02 );
+
+            x[0] = ( B_00 * b[0] + B_01 * b[1] + B_02 * b[2] ) * det_inv;
+            x[1] = ( B_01 * b[0] + B_11 * b[1] + B_12 * b[2] ) * det_inv;
+            x[2] = ( B_02 * b[0] + B_12 * b[1] + B_22 * b[2] ) * det_inv;
+        }
+        else
+        {
+            // The same minors as in SymmetricDet.
+            const Real s_0 = A[0][0] * A[1][1] - A[0][1] * A[0][1];
+            const Real s_1 = A[0][0] * A[1][2] - A[0][1] * A[0][2];
+            const Real s_2 = A[0][0] * A[1][3] - A[0][1] * A[0][3];
+            const Real s_3 = A[0][1] * A[1][2] - A[1][1] * A[0][2];
+            const Real s_4 = A[0][1] * A[1][3] - A[1][1] * A[0][3];
+            const Real s_5 = A[0][2] * A[1][3] - A[1][2] * A[0][3];
+
+            const Real c_5 = A[2][2] * A[3][3] - A[2][3] * A[2][3];
+            const Real c_4 = A[1][2] * A[3][3] - A[1][3] * A[2][3];
+            const Real c_3 = A[1][2] * A[2][3] - A[1][3] * A[2][2];
+            const Real c_2 = A[0][2] * A[3][3] - A[0][3] * A[2][3];
+            const Real c_1 = A[0][2] * A[2][3] - A[0][3] * A[2][2];
+            const Real c_0 = A[0][2] * A[1][3] - A[0][3] * A[1][2];
+
+            const Real det_inv = Real(1) / ( s_0 * c_5 - s_1 * c_4 + s_2 * c_3 + s_3 * c_2 - s_4 * c_1 + s_5 * c_0 );
+
+            // The upper triangle of the adjugate; it is symmetric.
+            const Real B_00 =   A[1][1] * c_5 - A[1][2] * c_4 + A[1][3] * c_3;
+            const Real B_01 = - A[0][1] * c_5 + A[0][2] * c_4 - A[0][3] * c_3;
+            const Real B_02 =   A[1][3] * s_5 - A[2][3] * s_4 + A[3][3] * s_3;
+            const Real B_03 = - A[1][2] * s_5 + A[2][2] * s_4 - A[2][3] * s_3;
+            const Real B_11 =   A[0][0] * c_5 - A[0][2] * c_2 + A[0][3] * c_1;
+            const Real B_12 = - A[0][3] * s_5 + A[2][3] * s_2 - A[3][3] * s_1;
+            const Real B_13 =   A[0][2] * s_5 - A[2][2] * s_2 + A[2][3] * s_1;
+            const Real B_22 =   A[0][3] * s_4 - A[1][3] * s_2 + A[3][3] * s_0;
+            const Real B_23 = - A[0][2] * s_4 + A[1][2] * s_2 - A[2][3] * s_0;
+            const Real B_33 =   A[0][2] * s_3 - A[1][2] * s_1 + A[2][2] * s_0;
+
+            x[0] = ( B_00 * b[0] + B_01 * b[1] + B_02 * b[2] + B_03 * b[3] ) * det_inv;
+            x[1] = ( B_01 * b[0] + B_11 * b[1] + B_12 * b[2] + B_13 * b[3] ) * det_inv;
+            x[2] = ( B_02 * b[0] + B_12 * b[1] + B_22 * b[2] + B_23 * b[3] ) * det_inv;
+            x[3] = ( B_03 * b[0] + B_13 * b[1] + B_23 * b[2] + B_33 * b[3] ) * det_inv;
+        }
+    }
+
+/*!
+ * @brief Returns the smallest eigenvalue of the symmetric `d` x `d` matrix `A` for `d` = 2, 3.
+ *
+ * For `d` = 2, the smaller root of the characteristic quadratic is computed as determinant divided by the greater root, which avoids cancellation for positive semidefinite matrices. For `d` = 3, the roots of the characteristic cubic are computed by the trigonometric method of [Smith - _Eigenvalues of a symmetric 3 x 3 matrix_ (1961)](https://doi.org/10.1145/355578.366316). The absolute error is a small multiple of machine precision times the norm of `A`, as for an iterative eigensolver.
+ */
+
+    template<int d, typename Real, typename Matrix_T>
+    Real SymmetricSmallestEigenvalue( const Matrix_T & A )
+    {
+        static_assert( (d == 2) || (d == 3), "" );
+
+        if constexpr ( d == 2 )
+        {
+            const Real m = Real(0.5) * ( A[0][0] + A[1][1] );
+            const Real h = Real(0.5) * ( A[0][0] - A[1][1] );
+
+            const Real root = std::sqrt( h * h + A[0][1] * A[0][1] );
+
+            const Real lambda_max = m + root;
+
+            return (lambda_max > Real(0))
+                ? ( A[0][0] * A[1][1] - A[0][1] * A[0][1] ) / lambda_max
+                : m - root;
+        }
+        else
+        {
+            const Real q = ( A[0][0] + A[1][1] + A[2][2] ) / Real(3);
+
+            const Real a_00 = A[0][0] - q;
+            const Real a_11 = A[1][1] - q;
+            const Real a_22 = A[2][2] - q;
+
+            const Real off = A[0][1] * A[0][1] + A[0][2] * A[0][2] + A[1][2] * A[1][2];
+
+            // p^2 = tr( (A - q I)^2 ) / 6
+            const Real p = std::sqrt( ( a_00 * a_00 + a_11 * a_11 + a_22 * a_22 + Real(2) * off ) / Real(6) );
+
+            // A multiple of the identity has p = 0; then r = 0 below and all three eigenvalues are q.
+            const Real p_inv = (p > Real(0)) ? Real(1) / p : Real(0);
+
+            // r = det( (A - q I) / p ) / 2 lies in [-1,1] up to rounding.
+            const Real det =
+                  a_00 * ( a_11 * a_22 - A[1][2] * A[1][2] )
+                - A[0][1] * ( A[0][1] * a_22 - A[1][2] * A[0][2] )
+                + A[0][2] * ( A[0][1] * A[1][2] - a_11 * A[0][2] );
+
+            const Real r = std::clamp( Real(0.5) * det * p_inv * p_inv * p_inv, Real(-1), Real(1) );
+
+            const Real phi = std::acos( r ) / Real(3);
+
+            // The eigenvalues are q + 2 p cos( phi + 2 pi k / 3 ) for k = 0, 1, 2; k = 1 gives the smallest one.
+            return q + Real(2) * p * std::cos( phi + Scalar::TwoPi<Real> / Real(3) );
+        }
+    }
+
+} // namespace CoBarS
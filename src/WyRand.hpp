@@ -24,11 +24,40 @@ namespace CoBarS
         
         wy::rand random_engine;
         
+        // wy::rand adds 0xa0761d6478bd642f to its state in each draw; this is the increment for 2^32 draws.
+        static constexpr std::uint64_t stream_increment = std::uint64_t(0xa0761d6478bd642f) << 32;
+        
     public:
         
         WyRand() 
         {}
         
+        /*!
+         * @brief Deterministic seeding: The state of `wy::rand` is a counter that is incremented by a constant in each draw. So we can put stream `stream` at draw number `stream` * 2^32 in O(1). Different streams do not overlap for the first 2^32 draws.
+         */
+        
+        WyRand( const std::uint64_t seed, const std::uint64_t stream ) noexcept
+        :   random_engine( seed + stream * stream_increment )
+        {}
+        
+        /*!
+         * @brief Jumps from the beginning of the current stream to the beginning of the next one. Call this only on an instance that has not been used since it was constructed or since the last call to `NextStream`.
+         */
+        
+        void NextStream() noexcept
+        {
+            random_engine.state += stream_increment;
+        }
+        
+        /*!
+         * @brief Skips the next `count` draws in O(1).
+         */
+        
+        void discard( const std::uint64_t count ) noexcept
+        {
+            random_engine.state += count * std::uint64_t(0xa0761d6478bd642f);
+        }
+        
         ~WyRand() = default;
 
         result_type operator()() noexcept
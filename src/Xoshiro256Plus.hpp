@@ -1,6 +1,7 @@
 #pragma once
 #include <cstdint>
 #include <array>
+#include <vector>
 
 #include "../deps/Xoshiro-cpp/XoshiroCpp.hpp"
 
@@ -37,11 +38,57 @@ namespace CoBarS
             random_engine = XoshiroCpp::Xoshiro256Plus( seeds );
         }
         
+        /*!
+         * @brief Deterministic seeding: Seeds the state from `seed` and then advances it by `stream` calls of `jump()`. This uses precomputed powers of the jump map, so it costs O(log(`stream`)). Different streams do not overlap for the first 2^128 draws.
+         */
+        
+        Xoshiro256Plus( const std::uint64_t seed, const std::uint64_t stream ) noexcept
+        :   random_engine( seed )
+        {
+            if( stream == 0 )
+            {
+                return;
+            }
+            
+            random_engine.deserialize( ApplyPower( JumpPowers(), stream, random_engine.serialize() ) );
+        }
+        
+        /*!
+         * @brief Jumps from the beginning of the current stream to the beginning of the next one. Call this only on an instance that has not been used since it was constructed or since the last call to `NextStream`.
+         */
+        
+        void NextStream() noexcept
+        {
+            random_engine.jump();
+        }
+        
         result_type operator()() noexcept
         {
             return random_engine();
         }
         
+        /*!
+         * @brief Skips the next `count` draws. For large `count`, this uses precomputed powers of the state transition, so it costs O(log(`count`)).
+         */
+        
+        void discard( const std::uint64_t count ) noexcept
+        {
+            // Applying one of the linear maps costs about as much as 1000 draws, and we may need up to log2(count) of them. So below this, drawing is cheaper.
+            constexpr std::uint64_t draw_threshold = 16384;
+            
+            if( count < draw_threshold )
+            {
+                for( std::uint64_t i = 0; i < count; ++i )
+                {
+                    (void)random_engine();
+                }
+            }
+            else
+            {
+                random_engine.deserialize( ApplyPower( StepPowers(), count, random_engine.serialize() ) );
+            }
+        }
+        
         
         static constexpr result_type min() noexcept
         {
@@ -57,6 +104,101 @@ namespace CoBarS
         {
             return std::string("Xoshiro256Plus");
         }
+        
+    private:
+        
+        using State_T = XoshiroCpp::Xoshiro256Plus::state_type;
+        
+        // The state transition of xoshiro256+ is linear over GF(2). So is `jump()`, and we store a linear map on the 256-bit states by the images of the 256 unit vectors.
+        using LinearMap_T = std::array<State_T,256>;
+        
+        static State_T Apply( const LinearMap_T & L, const State_T & state ) noexcept
+        {
+            State_T result {};
+            
+            for( std::size_t w = 0; w < 4; ++w )
+            {
+                for( std::size_t b = 0; b < 64; ++b )
+                {
+                    if( (state[w] >> b) & std::uint64_t(1) )
+                    {
+                        const State_T & column = L[64 * w + b];
+                        
+                        result[0] ^= column[0];
+                        result[1] ^= column[1];
+                        result[2] ^= column[2];
+                        result[3] ^= column[3];
+                    }
+                }
+            }
+            
+            return result;
+        }
+        
+        // Applies the map whose 2^i-th power is powers[i] exponent times to state. The powers commute, so we can apply them in any order.
+        static State_T ApplyPower(
+            const std::vector<LinearMap_T> & powers, const std::uint64_t exponent, State_T state
+        ) noexcept
+        {
+            for( std::size_t i = 0; i < 64; ++i )
+            {
+                if( (exponent >> i) & std::uint64_t(1) )
+                {
+                    state = Apply( powers[i], state );
+                }
+            }
+            
+            return state;
+        }
+        
+        // Returns the maps that advance the state of an engine as f does 2^0, 2^1, ..., 2^63 times, computed by repeated squaring.
+        template<typename F>
+        static std::vector<LinearMap_T> PowersOfTwo( F && f )
+        {
+            std::vector<LinearMap_T> P ( 64 );
+            
+            for( std::size_t j = 0; j < 256; ++j )
+            {
+                State_T e {};
+                
+                e[j / 64] = std::uint64_t(1) << (j % 64);
+                
+                XoshiroCpp::Xoshiro256Plus engine ( e );
+                
+                f( engine );
+                
+                P[0][j] = engine.serialize();
+            }
+            
+            for( std::size_t i = 1; i < 64; ++i )
+            {
+                for( std::size_t j = 0; j < 256; ++j )
+                {
+                    P[i][j] = Apply( P[i-1], P[i-1][j] );
+                }
+            }
+            
+            return P;
+        }
+        
+        // JumpPowers()[i] is the map that calls `jump()` 2^i times; StepPowers()[i] is the map that draws 2^i times. Each table takes 512 KiB; it is computed on first use and shared by all instances. The initialization of function-local statics is thread-safe.
+        static const std::vector<LinearMap_T> & JumpPowers() noexcept
+        {
+            static const std::vector<LinearMap_T> jump_powers = PowersOfTwo(
+                []( XoshiroCpp::Xoshiro256Plus & engine ) { engine.jump(); }
+            );
+            
+            return jump_powers;
+        }
+        
+        static const std::vector<LinearMap_T> & StepPowers() noexcept
+        {
+            static const std::vector<LinearMap_T> step_powers = PowersOfTwo(
+                []( XoshiroCpp::Xoshiro256Plus & engine ) { (void)engine(); }
+            );
+            
+            return step_powers;
+        }
     };
     
 } // namespace CoBarS